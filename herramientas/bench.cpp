@@ -0,0 +1,593 @@
+// Microbenchmarks de los caminos calientes de la simulación.
+//
+// Cada caso usa semillas fijas, se calibra para que una muestra dure al menos
+// --tiempo-muestra ms y se repite --muestras veces. Se reporta la mediana por
+// operación con su desviación absoluta mediana (MAD), la media, la desviación
+// estándar y el intervalo de confianza del 95 % de la media.
+//
+// Uso: bench [--filtro texto] [--muestras N] [--tiempo-muestra ms] [--csv]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nucleo/Guardado.h"
+#include "nucleo/Juego.h"
+#include "nucleo/PaqueteNiveles.h"
+
+namespace {
+
+// Impide que el compilador descarte el cálculo que se está midiendo
+template <class T>
+inline void noOptimizar(const T& valor) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(valor) : "memory");
+#else
+    static volatile const T* sumidero;
+    sumidero = &valor;
+#endif
+}
+
+struct Opciones {
+    std::string filtro;
+    int muestras = 30;
+    double msPorMuestra = 20.0;
+    bool csv = false;
+};
+
+struct Resultado {
+    std::string nombre;
+    long long iteraciones = 0;
+    double mediana = 0, mad = 0, media = 0, desv = 0, ic95 = 0;
+};
+
+using Reloj = std::chrono::steady_clock;
+
+// f(n) ejecuta n operaciones; la preparación va fuera de f
+template <class F>
+Resultado medir(const std::string& nombre, const Opciones& op, F&& f) {
+    // Calentamiento y calibración: duplicar n hasta que un lote llene la muestra
+    long long n = 1;
+    for (;;) {
+        auto t0 = Reloj::now();
+        f(n);
+        double ms = std::chrono::duration<double, std::milli>(Reloj::now() - t0).count();
+        if (ms >= op.msPorMuestra || n >= (1LL << 40)) break;
+        n = (ms < op.msPorMuestra / 16) ? n * 8 : n * 2;
+    }
+
+    std::vector<double> ns;
+    ns.reserve(op.muestras);
+    for (int m = 0; m < op.muestras; m++) {
+        auto t0 = Reloj::now();
+        f(n);
+        double total = std::chrono::duration<double, std::nano>(Reloj::now() - t0).count();
+        ns.push_back(total / static_cast<double>(n));
+    }
+
+    Resultado r;
+    r.nombre = nombre;
+    r.iteraciones = n;
+    std::vector<double> orden = ns;
+    std::sort(orden.begin(), orden.end());
+    auto medianaDe = [](const std::vector<double>& v) {
+        size_t k = v.size();
+        return (k % 2) ? v[k / 2] : 0.5 * (v[k / 2 - 1] + v[k / 2]);
+    };
+    r.mediana = medianaDe(orden);
+    std::vector<double> desvios;
+    for (double x : ns) desvios.push_back(std::fabs(x - r.mediana));
+    std::sort(desvios.begin(), desvios.end());
+    r.mad = medianaDe(desvios);
+    for (double x : ns) r.media += x;
+    r.media /= ns.size();
+    for (double x : ns) r.desv += (x - r.media) * (x - r.media);
+    r.desv = ns.size() > 1 ? std::sqrt(r.desv / (ns.size() - 1)) : 0.0;
+    r.ic95 = 1.96 * r.desv / std::sqrt(static_cast<double>(ns.size()));
+    return r;
+}
+
+void imprimir(const Resultado& r, const Opciones& op) {
+    if (op.csv) {
+        std::printf("%s,%lld,%.3f,%.3f,%.3f,%.3f,%.3f\n", r.nombre.c_str(), r.iteraciones,
+                    r.mediana, r.mad, r.media, r.desv, r.ic95);
+    } else {
+        std::printf("%-34s %12.1f ns  ±%8.1f (MAD)  media %12.1f ± %.1f (IC95)  [%lld it/muestra]\n",
+                    r.nombre.c_str(), r.mediana, r.mad, r.media, r.ic95, r.iteraciones);
+    }
+    std::fflush(stdout);
+}
+
+const uint64_t SEMILLA = 12345;
+
+// ---------------- Casos ----------------
+
+// Un tick completo sin bot: enemigos + QuadTree + frutas. Cuando la partida
+// termina se reinicia el mismo nivel con la siguiente semilla del generador de
+// la partida, así la secuencia es idéntica en cada ejecución.
+void casoActualizar(const Opciones& op, int nivel) {
+    Juego juego;
+    juego.iniciarNivel(nivel, SEMILLA);
+    imprimir(medir("Juego::actualizar/nivel" + std::to_string(nivel), op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            if (juego.estado != Jugando) juego.iniciarNivel(nivel);
+            juego.actualizar();
+        }
+        noOptimizar(juego.ticksDesdeInicio);
+    }), op);
+}
+
+// Mismo tick en un tablero grande de tamaño elegido al ejecutar, con
+// enemigosPorNivel * 6 enemigos
+void casoActualizarDinamico(const Opciones& op, int lado, int enemigosPorNivel) {
+    ConfigDinamica cfg;
+    cfg.lado = lado;
+    cfg.enemigosPorNivel = enemigosPorNivel;
+    JuegoDinamico juego(cfg);
+    juego.iniciarNivel(6, SEMILLA);
+    std::string nombre = "JuegoDinamico::actualizar/" + std::to_string(lado) + "x" + std::to_string(lado) +
+                         "/x" + std::to_string(juego.numEnemigos);
+    imprimir(medir(nombre, op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            if (juego.estado != Jugando) juego.iniciarNivel(6);
+            juego.actualizar();
+        }
+        noOptimizar(juego.ticksDesdeInicio);
+    }), op);
+}
+
+void casoQuadTree(const Opciones& op) {
+    // Posiciones de enemigos precalculadas: cada operación reconstruye el árbol
+    // con MAX_ENEMIGOS puntos y consulta la celda del jugador, como un tick
+    Aleatorio rng(SEMILLA);
+    const int NUM_ESCENAS = 1024;
+    std::vector<double> pos(NUM_ESCENAS * MAX_ENEMIGOS * 2);
+    for (auto& v : pos) v = 1 + rng.acotado(TAM_TABLERO - 2) + 0.5;
+    std::vector<int> jugador(NUM_ESCENAS * 2);
+    for (auto& v : jugador) v = 1 + rng.acotado(TAM_TABLERO - 2);
+
+    QuadTree qt(0.0, 0.0, static_cast<double>(TAM_TABLERO), static_cast<double>(TAM_TABLERO));
+    imprimir(medir("QuadTree/limpiar+insertar+consulta", op, [&](long long n) {
+        int hits = 0;
+        for (long long i = 0; i < n; i++) {
+            int e = static_cast<int>(i % NUM_ESCENAS);
+            qt.limpiar();
+            const double* p = &pos[e * MAX_ENEMIGOS * 2];
+            for (int k = 0; k < MAX_ENEMIGOS; k++) qt.insertar(p[2 * k], p[2 * k + 1]);
+            hits += qt.hayPuntosEnCelda(jugador[2 * e], jugador[2 * e + 1]);
+        }
+        noOptimizar(hits);
+    }), op);
+}
+
+void casoRayos(const Opciones& op) {
+    // Tablero sin muros interiores lleno de fruta; el jugador en el centro
+    // congela y descongela en las cuatro direcciones (el tablero vuelve al
+    // estado inicial tras cada par)
+    Aleatorio rng(SEMILLA);
+    Mapa mapa;
+    mapa.inicializar();
+    EntidadesVivas<Fruta, MAX_FRUTAS> vivas;
+    CasillasLibres<celdasTablero(TAM_TABLERO)> libres;
+    mapa.ponerFrutas(vivas, Uva, MAX_FRUTAS, rng, libres);
+    Fruta* frutas = vivas.data();
+    Ocupacion ocupacion;
+    ocupacion.limpiar();
+    for (int i = 0; i < vivas.tamano(); i++)
+        ocupacion.ponerFruta(frutas[i].pos.celdaY(), frutas[i].pos.celdaX(), i);
+    Jugador jug;
+    jug.pos = Posicion(TAM_TABLERO / 2, TAM_TABLERO / 2);
+    const Direccion dirs[4] = {Arriba, Abajo, Izquierda, Derecha};
+
+    imprimir(medir("CongelarDescongelar/congelar", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            jug.dir = dirs[i & 3];
+            CongelarDescongelar::congelar(jug, mapa, ocupacion, frutas);
+            if ((i & 3) == 3)
+                for (Direccion d : dirs) {
+                    jug.dir = d;
+                    CongelarDescongelar::descongelar(jug, mapa, ocupacion, frutas);
+                }
+        }
+        noOptimizar(frutas[0].congelada);
+    }), op);
+
+    imprimir(medir("CongelarDescongelar/descongelar", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            jug.dir = dirs[i & 3];
+            CongelarDescongelar::descongelar(jug, mapa, ocupacion, frutas);
+        }
+        noOptimizar(frutas[0].congelada);
+    }), op);
+}
+
+// Lo que recorre más de una palabra en PlanoBits<DINAMICO> (el lado de 1024
+// son 16 palabras por línea y 16384 por plano): los rayos de punta a punta de
+// una fila vacía, la búsqueda del obstáculo sola y vacio() con la única
+// casilla puesta al final del plano
+void casoPlanoGrande(const Opciones& op) {
+    const int lado = 1024;
+    ConfigDinamica cfg;
+    cfg.lado = lado;
+    MapaT<ConfigDinamica> mapa(cfg);
+    mapa.inicializar();
+    OcupacionT<ConfigDinamica> ocupacion(cfg);
+    ocupacion.limpiar();
+    Fruta* frutas = nullptr; // sin frutas: marcarFruta no llega a usarlo
+    Jugador jug;
+    jug.pos = Posicion(1, lado / 2);
+    const std::string sufijo = "/" + std::to_string(lado) + "x" + std::to_string(lado);
+
+    imprimir(medir("CongelarDescongelar/par" + sufijo, op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            jug.dir = Derecha;
+            CongelarDescongelar::congelar(jug, mapa, ocupacion, frutas);
+            CongelarDescongelar::descongelar(jug, mapa, ocupacion, frutas);
+        }
+        noOptimizar(mapa.version());
+    }), op);
+
+    const auto& muros = mapa.plano(Muro);
+    const auto& enemigos = ocupacion.planoEnemigos();
+    imprimir(medir("primerBloqueo" + sufijo, op, [&](long long n) {
+        int r = 0;
+        for (long long i = 0; i < n; i++)
+            r += primerBloqueo([&](int k) { return muros.bloque(true, lado / 2, k) | enemigos.bloque(true, lado / 2, k); },
+                               1, true);
+        noOptimizar(r);
+    }), op);
+
+    PlanoBits<DINAMICO> plano;
+    plano.dimensionar(lado);
+    plano.limpiar();
+    plano.poner(lado - 1, lado - 1);
+    imprimir(medir("PlanoBits::vacio" + sufijo, op, [&](long long n) {
+        int r = 0;
+        for (long long i = 0; i < n; i++) {
+            noOptimizar(plano.w[0]);
+            r += plano.vacio();
+        }
+        noOptimizar(r);
+    }), op);
+}
+
+void casoEnemigos(const Opciones& op) {
+    // Los enemigos del nivel 6 deambulan sin que el jugador se mueva
+    Juego juego;
+    juego.iniciarNivel(6, SEMILLA);
+    imprimir(medir("LogicaEnemigo::actualizar/x" + std::to_string(juego.numEnemigos), op, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            for (int k = 0; k < juego.numEnemigos; k++)
+                LogicaEnemigo::actualizar(juego.enemigos[k], juego.jugador, juego.mapa, juego.ocupacion,
+                                          juego.enemigos[k].tipo == Especial ? juego.campoEspecial : juego.campoNormal,
+                                          juego.rng);
+        noOptimizar(juego.enemigos[0].pos.x);
+    }), op);
+}
+
+// Modo horda: miles de enemigos en un 1024x1024 que deambulan con el jugador
+// quieto. Se compara un tick de los núcleos por campos con el mismo tick
+// enemigo a enemigo sobre una copia en arreglo de Enemigo. Como la horda se
+// va juntando alrededor del jugador, cada TICKS_HORDA ticks los enemigos, su
+// ocupación y el generador vuelven a como estaban: los dos casos miden la
+// misma partida.
+const int TICKS_HORDA = 64;
+
+void casoHorda(const Opciones& op) {
+    ConfigDinamica cfg;
+    cfg.lado = 1024;
+    cfg.topeEnemigos = 4096;
+    cfg.enemigosPorNivel = cfg.topeEnemigos;
+    JuegoDinamico juego(cfg);
+    juego.iniciarNivel(6, SEMILLA);
+    // Un primer tick construye los campos de distancias y el paso
+    juego.actualizar();
+    const int num = juego.numEnemigos;
+    const HordaEnemigos horda = juego.enemigos;
+    const Aleatorio rng = juego.rng;
+    auto volver = [&](auto&& enemigo) {
+        for (int k = 0; k < num; k++) {
+            Posicion p = enemigo(k).pos, q = horda[k].pos;
+            juego.ocupacion.moverEnemigo(p.celdaY(), p.celdaX(), q.celdaY(), q.celdaX());
+        }
+        juego.rng = rng;
+    };
+    auto porEnemigo = [&](const Resultado& r) {
+        imprimir(r, op);
+        if (!op.csv) std::printf("%-34s %12.2f ns/enemigo  (%.1f M enemigos/s)\n", "", r.mediana / num,
+                                 num / r.mediana * 1e3);
+    };
+    const std::string sufijo = "/x" + std::to_string(num);
+
+    porEnemigo(medir("LogicaHorda::actualizar" + sufijo, op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            if (i % TICKS_HORDA == 0) {
+                volver([&](int k) { return juego.enemigos[k]; });
+                juego.enemigos = horda;
+            }
+            LogicaHorda::actualizar(juego.enemigos, num, juego.jugador, juego.mapa, juego.ocupacion,
+                                    juego.campoNormal, juego.campoEspecial, juego.pasoHorda, juego.rng);
+        }
+        noOptimizar(juego.enemigos.x[0]);
+    }));
+
+    std::vector<Enemigo> sueltos(num);
+    for (int k = 0; k < num; k++) sueltos[k] = juego.enemigos[k];
+    porEnemigo(medir("LogicaEnemigo::actualizar" + sufijo, op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            if (i % TICKS_HORDA == 0) {
+                volver([&](int k) { return sueltos[k]; });
+                for (int k = 0; k < num; k++) sueltos[k] = horda[k];
+            }
+            for (Enemigo& e : sueltos)
+                LogicaEnemigo::actualizar(e, juego.jugador, juego.mapa, juego.ocupacion,
+                                          e.tipo == Especial ? juego.campoEspecial : juego.campoNormal, juego.rng);
+        }
+        noOptimizar(sueltos[0].pos.x);
+    }));
+
+    // Casilla sin enemigos: recorre la horda entera
+    porEnemigo(medir("LogicaHorda::primeroEnCelda" + sufijo, op, [&](long long n) {
+        int r = 0;
+        for (long long i = 0; i < n; i++) r += LogicaHorda::primeroEnCelda(juego.enemigos, num, 0, 0);
+        noOptimizar(r);
+    }));
+}
+
+// Campo de distancias hacia el jugador en el tablero clásico tras cambios de
+// hielo: cada operación crea y rompe un bloque (dos cambios que tocan a los
+// Normal) y, tras cada uno, los 6 enemigos piden su paso. Por capas, como lo
+// usa el juego, el campo se rehace; con dist[] en un tablero dinámico de 15
+// de lado con los mismos muros se repara, o se rehace para comparar.
+template <class Cfg>
+void campoTrasHielo(const Opciones& op, const std::string& nombre, const Cfg& cfg, bool rehacer) {
+    Aleatorio rng(SEMILLA);
+    MapaT<Cfg> mapa(cfg);
+    mapa.inicializar();
+    const int centro = TAM_TABLERO / 2;
+    mapa.ponerMurosAleatorios(rng, centro, centro);
+    std::vector<int> vacias;
+    for (int r = 1; r < TAM_TABLERO - 1; r++)
+        for (int c = 1; c < TAM_TABLERO - 1; c++)
+            if (mapa.obtenerCelda(r, c) == Vacia && (r != centro || c != centro)) vacias.push_back(r * TAM_TABLERO + c);
+    int enemigos[MAX_ENEMIGOS];
+    for (int k = 0; k < MAX_ENEMIGOS; k++) enemigos[k] = vacias[(k * 37) % vacias.size()];
+    CampoDistancias<Cfg> campo(PasoNormal, cfg);
+    auto consultar = [&] {
+        if (rehacer) campo.invalidar();
+        campo.actualizar(mapa, centro, centro);
+        int pasos = 0;
+        for (int e : enemigos) pasos += campo.siguientePaso(e / TAM_TABLERO, e % TAM_TABLERO);
+        return pasos;
+    };
+    consultar();
+    imprimir(medir(nombre, op, [&](long long n) {
+        int pasos = 0;
+        for (long long i = 0; i < n; i++) {
+            int v = vacias[i % vacias.size()];
+            mapa.crearHielo(v / TAM_TABLERO, v % TAM_TABLERO);
+            pasos += consultar();
+            mapa.romperHielo(v / TAM_TABLERO, v % TAM_TABLERO);
+            pasos += consultar();
+        }
+        noOptimizar(pasos);
+    }), op);
+}
+
+void casoCampoDistancias(const Opciones& op) {
+    ConfigDinamica quince;
+    quince.lado = TAM_TABLERO;
+    campoTrasHielo(op, "CampoDistancias/hielo capas rehacer", ConfigClasica(), false);
+    campoTrasHielo(op, "CampoDistancias/hielo dist[] reparar", quince, false);
+    campoTrasHielo(op, "CampoDistancias/hielo dist[] rehacer", quince, true);
+}
+
+void casoBot(const Opciones& op) {
+    // tickBot + verFrutas; el nivel se reinicia al recoger todo
+    Juego juego;
+    juego.esBot = true;
+    juego.iniciarNivel(4, SEMILLA);
+    imprimir(medir("Juego::tickBot", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            juego.tickBot();
+            juego.verFrutas();
+            juego.verSiGano();
+            if (juego.estado != Jugando) juego.iniciarNivel(4);
+        }
+        noOptimizar(juego.jugador.pos.x);
+    }), op);
+}
+
+// El mismo bot en un tablero grande: el coste por tick no debería crecer con
+// el lado (la ruta se repara, no se recalcula)
+void casoBotDinamico(const Opciones& op, int lado) {
+    ConfigDinamica cfg;
+    cfg.lado = lado;
+    JuegoDinamico juego(cfg);
+    juego.esBot = true;
+    juego.iniciarNivel(4, SEMILLA);
+    imprimir(medir("JuegoDinamico::tickBot/" + std::to_string(lado) + "x" + std::to_string(lado), op,
+                   [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            juego.tickBot();
+            juego.verFrutas();
+            juego.verSiGano();
+            if (juego.estado != Jugando) juego.iniciarNivel(4);
+        }
+        noOptimizar(juego.jugador.pos.x);
+    }), op);
+}
+
+void casoFrutas(const Opciones& op) {
+    Aleatorio rngMuros(SEMILLA);
+    Mapa base;
+    base.inicializar();
+    base.ponerMurosAleatorios(rngMuros, TAM_TABLERO / 2, TAM_TABLERO / 2);
+    Aleatorio rng(SEMILLA);
+    CasillasLibres<celdasTablero(TAM_TABLERO)> libres;
+    imprimir(medir("Mapa::ponerFrutas/15", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            Mapa m = base;
+            EntidadesVivas<Fruta, MAX_FRUTAS> frutas;
+            m.ponerFrutas(frutas, Uva, 15, rng, libres);
+            noOptimizar(frutas.tamano());
+        }
+    }), op);
+    // Más de las que caben con la separación: se llena el tablero
+    imprimir(medir("Mapa::ponerFrutas/30", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            Mapa m = base;
+            EntidadesVivas<Fruta, MAX_FRUTAS> frutas;
+            m.ponerFrutas(frutas, Uva, MAX_FRUTAS, rng, libres);
+            noOptimizar(frutas.tamano());
+        }
+    }), op);
+    ConfigDinamica cfg;
+    cfg.lado = 256;
+    MapaT<ConfigDinamica> grande(cfg);
+    EntidadesVivas<Fruta, DINAMICO> frutas;
+    CasillasLibres<DINAMICO> libresGrande;
+    imprimir(medir("MapaDinamico::ponerFrutas/256x256", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            grande.inicializar();
+            frutas.vaciar();
+            grande.ponerFrutas(frutas, Uva, cfg.uvasNivel(6), rng, libresGrande);
+            noOptimizar(frutas.tamano());
+        }
+    }), op);
+}
+
+// Muros con el hueco siempre conectado (cada muro candidato se mira en los
+// conjuntos disjuntos antes de ponerlo), en el clásico y en uno grande
+void casoMuros(const Opciones& op) {
+    Aleatorio rng(SEMILLA);
+    Mapa base;
+    base.inicializar();
+    imprimir(medir("Mapa::ponerMurosAleatorios/15", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            Mapa m = base;
+            m.ponerMurosAleatorios(rng, TAM_TABLERO / 2, TAM_TABLERO / 2);
+            noOptimizar(m.filaMuros(1));
+        }
+    }), op);
+    ConfigDinamica cfg;
+    cfg.lado = 64;
+    MapaT<ConfigDinamica> grande(cfg);
+    imprimir(medir("MapaDinamico::ponerMurosAleatorios/64x64", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            grande.inicializar();
+            grande.ponerMurosAleatorios(rng, cfg.lado / 2, cfg.lado / 2);
+            noOptimizar(grande.generacion());
+        }
+    }), op);
+}
+
+// Volver a una foto de la partida a media jugada: la copia del bloque y, tras
+// ella, el primer tick (que rehace los campos de distancias). Con decodificar
+// se suma la comprobación de la cabecera y del contenido.
+void casoGuardado(const Opciones& op) {
+    Juego juego;
+    juego.esBot = true;
+    juego.iniciarNivel(3, SEMILLA);
+    for (int i = 0; i < 5 && juego.estado == Jugando; i++) juego.actualizar();
+    DatosPartida foto = juego.guardar();
+    std::vector<uint8_t> bytes = Guardado::codificar(juego);
+    imprimir(medir("Juego::restaurar", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            juego.restaurar(foto);
+            noOptimizar(juego.ticksDesdeInicio);
+        }
+    }), op);
+    imprimir(medir("Juego::restaurar+actualizar", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            juego.restaurar(foto);
+            juego.actualizar();
+            noOptimizar(juego.ticksDesdeInicio);
+        }
+    }), op);
+    imprimir(medir("Guardado::decodificar/" + std::to_string(bytes.size()) + "B", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            bool ok = Guardado::decodificar(juego, bytes.data(), bytes.size());
+            noOptimizar(ok);
+        }
+    }), op);
+}
+
+// Empezar un nivel 6: generándolo (con y sin repetir hasta que sea jugable)
+// o desde niveles ya empaquetados, como los lee el juego del paquete proyectado
+void casoNiveles(const Opciones& op) {
+    const int nivel = 6;
+    Juego juego;
+    CampoDistancias<ConfigClasica> campo(PasoJugador, juego.cfg);
+    Aleatorio semillas(SEMILLA);
+    std::vector<NivelEmpaquetado> paquete;
+    while (paquete.size() < 4096) {
+        juego.iniciarNivel(nivel, semillas.siguiente());
+        if (nivelJugable(juego, campo)) paquete.push_back(empaquetarNivel(juego));
+    }
+    imprimir(medir("Juego::iniciarNivel/6", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            juego.iniciarNivel(nivel, semillas.siguiente());
+            noOptimizar(juego.frutas.tamano());
+        }
+    }), op);
+    imprimir(medir("iniciarNivel+nivelJugable/6", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            do juego.iniciarNivel(nivel, semillas.siguiente());
+            while (!nivelJugable(juego, campo));
+            noOptimizar(juego.frutas.tamano());
+        }
+    }), op);
+    size_t k = 0;
+    imprimir(medir("iniciarNivelEmpaquetado/6", op, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            bool ok = iniciarNivelEmpaquetado(juego, paquete[k++ % paquete.size()]);
+            noOptimizar(ok);
+        }
+    }), op);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Opciones op;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) op.filtro = argv[++i];
+        else if (std::strcmp(argv[i], "--muestras") == 0 && i + 1 < argc) op.muestras = std::max(2, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--tiempo-muestra") == 0 && i + 1 < argc) op.msPorMuestra = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--csv") == 0) op.csv = true;
+        else {
+            std::fprintf(stderr, "Uso: %s [--filtro texto] [--muestras N] [--tiempo-muestra ms] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (op.csv) std::printf("caso,iteraciones,mediana_ns,mad_ns,media_ns,desv_ns,ic95_ns\n");
+
+    auto activo = [&](const char* grupo) { return op.filtro.empty() || std::strstr(grupo, op.filtro.c_str()); };
+    if (activo("actualizar"))
+        for (int nivel = 1; nivel <= 6; nivel++) casoActualizar(op, nivel);
+    if (activo("JuegoDinamico")) {
+        casoActualizarDinamico(op, 64, 16);
+        casoActualizarDinamico(op, 1024, 64);
+    }
+    if (activo("QuadTree")) casoQuadTree(op);
+    if (activo("CongelarDescongelar")) casoRayos(op);
+    if (activo("CongelarDescongelar primerBloqueo PlanoBits")) casoPlanoGrande(op);
+    if (activo("LogicaEnemigo")) casoEnemigos(op);
+    if (activo("LogicaHorda LogicaEnemigo")) casoHorda(op);
+    if (activo("CampoDistancias")) casoCampoDistancias(op);
+    if (activo("tickBot")) {
+        casoBot(op);
+        casoBotDinamico(op, 64);
+        casoBotDinamico(op, 256);
+    }
+    if (activo("ponerMurosAleatorios")) casoMuros(op);
+    if (activo("ponerFrutas")) casoFrutas(op);
+    if (activo("Guardado restaurar")) casoGuardado(op);
+    if (activo("iniciarNivel empaquetado")) casoNiveles(op);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Genera un paquete de niveles (.icpn) para el tablero clásico: sortea niveles
+// con iniciarNivel(), descarta los que no son jugables (frutas que faltan o
+// inalcanzables, enemigos mal colocados) y escribe el resto ordenado por
+// número. Después abre el paquete proyectado y comprueba que cada nivel
+// empezado desde él queda igual que generado con su semilla.
+//
+// Uso: empaquetador SALIDA [--por-nivel N] [--niveles A-B] [--semilla S] [--sin-comprobar]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nucleo/Juego.h"
+#include "nucleo/PaqueteNiveles.h"
+#include "nucleo/Rollback.h"
+
+// Ticks que se juega cada nivel (con el bot) al comprobarlo
+static const int TICKS_COMPROBACION = 60;
+
+// Empieza el nivel de las dos maneras, lo juega un rato con el bot y compara
+static bool mismoNivel(Juego& generado, Juego& empaquetado, const NivelEmpaquetado& e) {
+    generado.esBot = empaquetado.esBot = true;
+    generado.iniciarNivel(e.nivel, e.semilla);
+    if (!iniciarNivelEmpaquetado(empaquetado, e)) return false;
+    for (int t = 0; t <= TICKS_COMPROBACION; t++) {
+        if (huellaPartida(generado.guardar()) != huellaPartida(empaquetado.guardar())) return false;
+        generado.actualizar();
+        empaquetado.actualizar();
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string salida;
+    long long porNivel = 1000;
+    int desde = 1, hasta = 6;
+    uint64_t semilla = 1;
+    bool comprobar = true;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--por-nivel") == 0 && i + 1 < argc) porNivel = std::max(1LL, std::atoll(argv[++i]));
+        else if (std::strcmp(argv[i], "--niveles") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%d-%d", &desde, &hasta) != 2) desde = hasta = std::atoi(argv[i]);
+        } else if (std::strcmp(argv[i], "--semilla") == 0 && i + 1 < argc) semilla = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--sin-comprobar") == 0) comprobar = false;
+        else if (argv[i][0] != '-' && salida.empty()) salida = argv[i];
+        else {
+            salida.clear();
+            break;
+        }
+    }
+    desde = std::max(desde, 1);
+    hasta = std::min(hasta, PaqueteNiveles::MAX_NIVEL);
+    if (salida.empty() || desde > hasta) {
+        std::fprintf(stderr, "Uso: %s SALIDA [--por-nivel N] [--niveles A-B] [--semilla S] [--sin-comprobar]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<NivelEmpaquetado> niveles;
+    niveles.reserve(static_cast<size_t>(porNivel) * (hasta - desde + 1));
+    Aleatorio semillas(semilla);
+    Juego juego;
+    CampoDistancias<ConfigClasica> campo(PasoJugador, juego.cfg);
+    std::printf("%-6s %10s %10s\n", "nivel", "guardados", "descartados");
+    for (int n = desde; n <= hasta; n++) {
+        long long descartados = 0;
+        for (long long k = 0; k < porNivel;) {
+            juego.iniciarNivel(n, semillas.siguiente());
+            if (!nivelJugable(juego, campo)) {
+                descartados++;
+                continue;
+            }
+            niveles.push_back(empaquetarNivel(juego));
+            k++;
+        }
+        std::printf("%-6d %10lld %10lld\n", n, porNivel, descartados);
+    }
+    if (!PaqueteNiveles::escribir(salida, niveles)) {
+        std::fprintf(stderr, "No se pudo escribir %s\n", salida.c_str());
+        return 1;
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    std::printf("%zu niveles, %zu bytes en %s (%.3f s)\n", niveles.size(),
+                niveles.size() * sizeof(NivelEmpaquetado), salida.c_str(), segundos);
+    if (!comprobar) return 0;
+
+    PaqueteNiveles paquete;
+    if (!paquete.abrir(salida) || paquete.total() != niveles.size()) {
+        std::fprintf(stderr, "%s: el paquete recién escrito no se puede abrir\n", salida.c_str());
+        return 2;
+    }
+    inicio = std::chrono::steady_clock::now();
+    Juego generado, empaquetado;
+    size_t distintos = 0;
+    for (size_t i = 0; i < paquete.total(); i++)
+        if (!mismoNivel(generado, empaquetado, paquete[i])) distintos++;
+    segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    std::printf("comprobados %zu niveles en %.3f s: %zu distintos de su semilla\n", paquete.total(), segundos,
+                distintos);
+    return distintos ? 2 : 0;
+}
@@ -0,0 +1,357 @@
+// Simulador headless: avanza Juego::actualizar() tan rápido como da la CPU,
+// sin QApplication ni QTimer, y reporta ticks por segundo.
+//
+// Uso: simulador [--nivel N] [--ticks T] [--semilla S] [--sin-bot]
+//                 [--lado L] [--enemigos-nivel E] [--tope-enemigos M]
+//      simulador --lote N [--hilos H] [--max-ticks T] [--semilla S]
+//      simulador --repeticion ARCHIVO [--repeticion ARCHIVO ...] [--max-ticks T]
+//      simulador --duelo-red [--segundos S] [--latencia MS] [--perdida P] [--nivel N] [--semilla S]
+//
+// Con --lado se juega en un tablero de LxL (JuegoDinamico) con E enemigos por
+// nivel y M como mucho, para estresar el motor con mapas grandes y hordas de
+// miles de enemigos.
+//
+// El modo lote juega N partidas del bot en cada nivel 1..6 repartidas en todos
+// los núcleos y muestra tasa de victoria, ticks hasta ganar y causas de muerte.
+//
+// Con --repeticion vuelve a jugar partidas grabadas (.icr) a toda velocidad y
+// avisa de las que ya no acaban como cuando se grabaron.
+//
+// --duelo-red enfrenta dos DueloRed con teclas al azar a 60 frames/s de reloj
+// virtual, unidos por enlaces con MS de latencia por sentido y P por mil de
+// datagramas perdidos. Comprueba cada huella confirmada de los dos lados contra
+// una partida normal jugada con las mismas entradas y mide cuánto cuesta el
+// frame más caro (vueltas atrás incluidas).
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nucleo/DueloRed.h"
+#include "nucleo/Juego.h"
+#include "nucleo/Lote.h"
+#include "nucleo/Repeticion.h"
+
+static const char* nombreEstado(EstadoJuego e) {
+    switch (e) {
+        case Menu: return "menu";
+        case Jugando: return "jugando";
+        case Ganaste: return "ganada";
+        case Perdiste: return "perdida";
+    }
+    return "?";
+}
+
+static int ejecutarRepeticiones(const std::vector<std::string>& rutas, int maxTicks) {
+    int distintas = 0, fallidas = 0;
+    long long ticks = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (const auto& ruta : rutas) {
+        Repeticion r;
+        if (!Repeticion::cargar(ruta, r)) {
+            std::printf("%s: no es una repeticion valida\n", ruta.c_str());
+            fallidas++;
+            continue;
+        }
+        // Las partidas se graban en la interfaz, que solo juega el tablero clásico
+        Juego juego;
+        ResultadoRepeticion res = reproducir(juego, r, maxTicks);
+        if (!res.valida) {
+            std::printf("%s: tablero de %dx%d, no el clasico\n", ruta.c_str(), r.lado, r.lado);
+            fallidas++;
+            continue;
+        }
+        ticks += res.ticks;
+        bool igual = res.coincide(r);
+        if (!igual) distintas++;
+        std::printf("%s: nivel %d, %zu eventos | %s en %d ticks, %d frutas", ruta.c_str(), r.nivel,
+                    r.eventos.size(), nombreEstado(res.estado), res.ticks, res.frutasRecogidas);
+        if (!igual)
+            std::printf("  DISTINTA (grabada: %s en %d ticks, %d frutas)", nombreEstado(r.estadoFinal),
+                        r.ticksFinal, r.frutasFinal);
+        std::printf("\n");
+    }
+    auto fin = std::chrono::steady_clock::now();
+    double segundos = std::chrono::duration<double>(fin - inicio).count();
+    std::printf("%zu repeticiones | %d distintas | %d sin reproducir | %lld ticks en %.3f s | %.0f ticks/s\n",
+                rutas.size(), distintas, fallidas, ticks, segundos, segundos > 0 ? ticks / segundos : 0.0);
+    return distintas || fallidas ? 2 : 0;
+}
+
+struct ConfigDueloRed {
+    int segundos = 60;
+    int latenciaMs = 100;
+    int perdidaPorMil = 0;
+    int nivel = 1;
+    uint64_t semilla = 1;
+};
+
+// Lo que se cuenta de un lado sumando todas las rondas
+struct ResumenLadoDuelo {
+    long long ticks = 0, vueltas = 0, ticksResimulados = 0, esperas = 0;
+    int maxVuelta = 0;
+    long long framesParados = 0, framesDobles = 0;
+    long long huellasComprobadas = 0, huellasDistintas = 0, desincronizadas = 0;
+    long long maxNsFrame = 0;
+};
+
+// Un lado del duelo y la partida de referencia con la que se compara
+struct LadoDuelo {
+    Juego partidas[2]; // [jugador 0, jugador 1]
+    DueloRed duelo;
+    Aleatorio teclas;
+    int fijadas = 0; // entradas propias ya copiadas al historial
+    Juego referencia[2];
+    int tickReferencia = 0;
+    int ultimaHuella = -1;
+
+    LadoDuelo(int yo, const DueloRed::Partida& p, uint64_t semillaTeclas)
+        : duelo(&partidas[yo], &partidas[1 - yo], yo == 0, p), teclas(semillaTeclas) {
+        for (auto& r : referencia) {
+            r.esBot = false;
+            r.ticksPorSegundo = p.ticksPorSegundo;
+            r.iniciarNivel(p.nivel, p.semilla);
+        }
+    }
+
+    bool terminada() const { return partidas[0].estado != Jugando && partidas[1].estado != Jugando; }
+};
+
+// Una partida del duelo hasta que acaban los dos jugadores (y se ha comprobado
+// la huella de después) o se llega a maxFrames; devuelve los frames jugados
+static long long jugarRondaDuelo(const ConfigDueloRed& cfg, uint64_t semilla, long long maxFrames,
+                                 ResumenLadoDuelo res[2]) {
+    const int64_t nsFrame = 1000000000LL / 60;
+    const int64_t latencia = static_cast<int64_t>(cfg.latenciaMs) * 1000000;
+    DueloRed::Partida p;
+    p.nivel = cfg.nivel;
+    p.semilla = semilla;
+    std::unique_ptr<LadoDuelo> lados[2] = {std::make_unique<LadoDuelo>(0, p, semilla * 2 + 1),
+                                          std::make_unique<LadoDuelo>(1, p, semilla * 2 + 2)};
+    // enlaces[k]: lo que manda el lado k al otro
+    EnlaceSimulado enlaces[2] = {EnlaceSimulado(latencia, cfg.perdidaPorMil, semilla + 11),
+                                 EnlaceSimulado(latencia, cfg.perdidaPorMil, semilla + 12)};
+    std::vector<EntradaTick> historial[2];
+    int finComprobado[2] = {-1, -1};
+
+    long long f = 0;
+    for (; f < maxFrames && (finComprobado[0] < 0 || finComprobado[1] < 0); f++) {
+        const int64_t ahora = f * nsFrame;
+        for (int k = 0; k < 2; k++) {
+            LadoDuelo& l = *lados[k];
+            enlaces[1 - k].sacarListos(ahora, [&](const std::vector<uint8_t>& d) {
+                l.duelo.recibir(d.data(), d.size(), ahora);
+            });
+            if (l.duelo.enMarcha()) {
+                int r = l.teclas.acotado(100);
+                Orden o;
+                if (r < 6) o.dir = static_cast<Direccion>(r % 5);
+                else if (r == 6) o.tipo = OrdenCongelar;
+                else if (r == 7) o.tipo = OrdenDescongelar;
+                if (r < 8) l.duelo.ordenLocal(o);
+            }
+
+            // El invitado va medio frame desfasado, como dos procesos de verdad
+            auto t0 = std::chrono::steady_clock::now();
+            int pasos = l.duelo.avanzar(ahora + k * nsFrame / 2, [&](std::vector<uint8_t> d) {
+                enlaces[k].meter(std::move(d), ahora);
+            });
+            auto t1 = std::chrono::steady_clock::now();
+            res[k].maxNsFrame = std::max<long long>(
+                res[k].maxNsFrame, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            // El primer segundo es el arranque: los lados aún se están igualando
+            if (f >= 60 && l.duelo.enMarcha()) {
+                if (pasos == 0) res[k].framesParados++;
+                if (pasos > 1) res[k].framesDobles++;
+            }
+
+            const SesionRollback& s = l.duelo.sesionRollback();
+            for (; l.fijadas < s.propiasFijadas(); l.fijadas++) historial[k].push_back(s.entradaLocal(l.fijadas));
+        }
+
+        // Cada huella nueva, contra la partida jugada sin red con las mismas entradas
+        for (int k = 0; k < 2; k++) {
+            LadoDuelo& l = *lados[k];
+            const SesionRollback& s = l.duelo.sesionRollback();
+            int h = s.tickUltimaHuella();
+            if (h < 0 || h == l.ultimaHuella) continue;
+            l.ultimaHuella = h;
+            for (; l.tickReferencia < h; l.tickReferencia++) {
+                for (int j = 0; j < 2; j++) {
+                    historial[j][l.tickReferencia].aplicarA(l.referencia[j]);
+                    l.referencia[j].actualizar();
+                }
+            }
+            res[k].huellasComprobadas++;
+            if (huellaDuelo(l.referencia[0].guardar(), l.referencia[1].guardar()) != s.valorUltimaHuella())
+                res[k].huellasDistintas++;
+            bool acabada = l.referencia[0].estado != Jugando && l.referencia[1].estado != Jugando;
+            if (acabada && l.terminada() && finComprobado[k] < 0) finComprobado[k] = h;
+        }
+    }
+
+    for (int k = 0; k < 2; k++) {
+        const SesionRollback& s = lados[k]->duelo.sesionRollback();
+        const EstadisticasRollback& e = s.estadisticas();
+        res[k].ticks += s.tick();
+        res[k].vueltas += e.vueltas;
+        res[k].ticksResimulados += e.ticksResimulados;
+        res[k].esperas += e.esperas;
+        res[k].maxVuelta = std::max(res[k].maxVuelta, e.maxVuelta);
+        if (s.desincronizado()) res[k].desincronizadas++;
+    }
+    return f;
+}
+
+static int ejecutarDueloRed(const ConfigDueloRed& cfg) {
+    ResumenLadoDuelo res[2];
+    const long long frames = static_cast<long long>(cfg.segundos) * 60;
+    long long jugados = 0;
+    int rondas = 0;
+    while (jugados < frames) jugados += jugarRondaDuelo(cfg, cfg.semilla + rondas++, frames - jugados, res);
+
+    std::printf("duelo en red: nivel %d, %d rondas en %d s a 60 Hz, %d ms por sentido, %d/1000 perdidos\n",
+                cfg.nivel, rondas, cfg.segundos, cfg.latenciaMs, cfg.perdidaPorMil);
+    std::printf("%-9s %7s %7s %11s %10s %7s %7s %6s %7s %10s\n", "lado", "ticks", "vueltas", "resimulados",
+                "max vuelta", "esperas", "parados", "dobles", "huellas", "max frame");
+    bool mal = false;
+    for (int k = 0; k < 2; k++) {
+        const ResumenLadoDuelo& r = res[k];
+        std::printf("%-9s %7lld %7lld %11lld %10d %7lld %7lld %6lld %7lld %7.1f us", k == 0 ? "anfitrion" : "invitado",
+                    r.ticks, r.vueltas, r.ticksResimulados, r.maxVuelta, r.esperas, r.framesParados,
+                    r.framesDobles, r.huellasComprobadas, r.maxNsFrame / 1000.0);
+        if (r.huellasDistintas) std::printf("  %lld DISTINTAS de la referencia", r.huellasDistintas);
+        if (r.desincronizadas) std::printf("  %lld rondas DESINCRONIZADAS", r.desincronizadas);
+        if (r.huellasComprobadas == 0) std::printf("  SIN COMPROBAR");
+        std::printf("\n");
+        mal = mal || r.huellasDistintas || r.desincronizadas || r.huellasComprobadas == 0;
+    }
+    return mal ? 2 : 0;
+}
+
+static int ejecutarModoLote(const ConfigLote& cfg, int hilos) {
+    PoolTrabajo pool(hilos);
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<EstadisticasNivel> res = ejecutarLote(cfg, pool);
+    auto fin = std::chrono::steady_clock::now();
+    double segundos = std::chrono::duration<double>(fin - inicio).count();
+
+    std::printf("%-6s %9s %8s %11s %9s %9s %9s %9s\n",
+                "nivel", "partidas", "victoria", "ticks(media)", "min", "max", "normal", "especial");
+    long long partidas = 0, ticks = 0;
+    for (const auto& e : res) {
+        std::printf("%-6d %9lld %7.2f%% %11.1f %9d %9d %9lld %9lld",
+                    e.nivel, e.partidas, 100.0 * e.tasaVictoria(), e.ticksMediosVictoria(),
+                    e.ganadas ? e.minTicksVictoria : 0, e.maxTicksVictoria,
+                    e.muertesNormal, e.muertesEspecial);
+        if (e.agotadas) std::printf("  (%lld sin terminar)", e.agotadas);
+        std::printf("\n");
+        partidas += e.partidas;
+        ticks += e.ticksTotales;
+    }
+    std::printf("%d hilos | %lld partidas en %.3f s | %.0f partidas/s | %.0f ticks/s\n",
+                pool.numHilos(), partidas, segundos,
+                segundos > 0 ? partidas / segundos : 0.0, segundos > 0 ? ticks / segundos : 0.0);
+    return 0;
+}
+
+// Avanza una partida (reiniciándola al terminar) hasta completar los ticks pedidos
+template <class J>
+static int ejecutarPartidas(J& juego, int nivel, long long ticksObjetivo, uint64_t semilla) {
+    juego.iniciarNivel(nivel, semilla);
+
+    long long ticks = 0, partidas = 1, ganadas = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    while (ticks < ticksObjetivo) {
+        if (juego.estado != Jugando) {
+            if (juego.estado == Ganaste) ganadas++;
+            juego.iniciarNivel(nivel);
+            partidas++;
+        }
+        juego.actualizar();
+        ticks++;
+    }
+    auto fin = std::chrono::steady_clock::now();
+
+    double segundos = std::chrono::duration<double>(fin - inicio).count();
+    std::printf("nivel %d | %dx%d, %d enemigos | %lld ticks en %.3f s | %.0f ticks/s | %lld partidas, %lld ganadas\n",
+                nivel, juego.cfg.tam(), juego.cfg.tam(), juego.numEnemigos, ticks, segundos,
+                segundos > 0 ? ticks / segundos : 0.0, partidas, ganadas);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int nivel = 1;
+    long long ticksObjetivo = 1000000;
+    bool bot = true;
+    uint64_t semilla = 1;
+    int lote = 0, hilos = 0;
+    ConfigLote cfg;
+    ConfigDinamica dinamica;
+    bool usarDinamica = false;
+    std::vector<std::string> repeticiones;
+    bool dueloRed = false;
+    ConfigDueloRed red;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--nivel") == 0 && i + 1 < argc) nivel = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) ticksObjetivo = std::atoll(argv[++i]);
+        else if (std::strcmp(argv[i], "--semilla") == 0 && i + 1 < argc) semilla = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--sin-bot") == 0) bot = false;
+        else if (std::strcmp(argv[i], "--lote") == 0 && i + 1 < argc) lote = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--hilos") == 0 && i + 1 < argc) hilos = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) cfg.maxTicks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--repeticion") == 0 && i + 1 < argc) repeticiones.push_back(argv[++i]);
+        else if (std::strcmp(argv[i], "--duelo-red") == 0) dueloRed = true;
+        else if (std::strcmp(argv[i], "--segundos") == 0 && i + 1 < argc) red.segundos = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--latencia") == 0 && i + 1 < argc) red.latenciaMs = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--perdida") == 0 && i + 1 < argc) red.perdidaPorMil = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--lado") == 0 && i + 1 < argc) {
+            dinamica.lado = std::max(5, std::atoi(argv[++i]));
+            usarDinamica = true;
+        } else if (std::strcmp(argv[i], "--enemigos-nivel") == 0 && i + 1 < argc) {
+            dinamica.enemigosPorNivel = std::max(1, std::atoi(argv[++i]));
+            usarDinamica = true;
+        } else if (std::strcmp(argv[i], "--tope-enemigos") == 0 && i + 1 < argc) {
+            dinamica.topeEnemigos = std::max(1, std::atoi(argv[++i]));
+            usarDinamica = true;
+        } else {
+            std::fprintf(stderr, "Uso: %s [--nivel N] [--ticks T] [--semilla S] [--sin-bot]\n"
+                                 "         [--lado L] [--enemigos-nivel E] [--tope-enemigos M]\n"
+                                 "       %s --lote N [--hilos H] [--max-ticks T] [--semilla S]\n"
+                                 "       %s --repeticion ARCHIVO [--repeticion ARCHIVO ...] [--max-ticks T]\n"
+                                 "       %s --duelo-red [--segundos S] [--latencia MS] [--perdida P] [--nivel N]\n",
+                         argv[0], argv[0], argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if (nivel < 1 || nivel > MAX_NIVEL) {
+        std::fprintf(stderr, "--nivel va de 1 a %d\n", MAX_NIVEL);
+        return 1;
+    }
+
+    if (dueloRed) {
+        red.nivel = nivel;
+        red.semilla = semilla;
+        return ejecutarDueloRed(red);
+    }
+    if (!repeticiones.empty()) return ejecutarRepeticiones(repeticiones, cfg.maxTicks);
+    if (lote > 0) {
+        cfg.partidasPorNivel = lote;
+        cfg.semillaBase = semilla;
+        return ejecutarModoLote(cfg, hilos);
+    }
+
+    if (usarDinamica) {
+        JuegoDinamico juego(dinamica);
+        juego.esBot = bot;
+        return ejecutarPartidas(juego, nivel, ticksObjetivo, semilla);
+    }
+    Juego juego;
+    juego.esBot = bot;
+    return ejecutarPartidas(juego, nivel, ticksObjetivo, semilla);
+}
@@ -14,642 +14,32 @@
 #include <QRandomGenerator>
 #include <QPixmap>
 #include <QImage>
-#include <QImageReader>
 #include <QDir>
+#include <QFile>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QScreen>
+#include <QPointF>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QNetworkDatagram>
 #include <cmath>
 #include <algorithm>
+#include <memory>
 #include <vector>
 
-const int TAM_TABLERO = 15;
-const int VEL_JUGADOR = 1;
-const float VEL_ENEMIGO_ESPECIAL = 0.6f;
-const float VEL_ENEMIGO_NORMAL = 0.6f;
-const int MAX_ENEMIGOS = 6;
-const int MAX_FRUTAS = 30;
-const float PROB_PERSECUCION = 0.8f;
-
-// ============= QuadTree (partición espacial para colisiones) =============
-struct PointQT {
-    double x, y;
-    PointQT() : x(0), y(0) {}
-    PointQT(double _x, double _y) : x(_x), y(_y) {}
-    bool operator==(const PointQT& o) const { return x == o.x && y == o.y; }
-};
-
-struct RectQT {
-    double x, y, ancho, alto;
-    RectQT() : x(0), y(0), ancho(0), alto(0) {}
-    RectQT(double _x, double _y, double _w, double _h) : x(_x), y(_y), ancho(_w), alto(_h) {}
-    bool contiene(const PointQT& p) const {
-        return p.x >= x && p.x <= x + ancho && p.y >= y && p.y <= y + alto;
-    }
-    bool intersecta(const RectQT& r) const {
-        return !(r.x > x + ancho || r.x + r.ancho < x || r.y > y + alto || r.y + r.alto < y);
-    }
-};
-
-class QuadTree {
-    static const int CAPACIDAD = 4;
-    static const int PROF_MAX = 6;
-
-    struct Nodo {
-        double x1, y1, x2, y2;
-        bool esHoja = true;
-        std::vector<PointQT> puntos;
-        Nodo *nw = nullptr, *ne = nullptr, *sw = nullptr, *se = nullptr;
-        int profundidad = 0;
-
-        Nodo(double _x1, double _y1, double _x2, double _y2, int prof)
-            : x1(_x1), y1(_y1), x2(_x2), y2(_y2), profundidad(prof) {}
-
-        ~Nodo() {
-            delete nw; delete ne; delete sw; delete se;
-        }
-
-        bool contiene(double px, double py) const {
-            return px >= x1 && px <= x2 && py >= y1 && py <= y2;
-        }
-
-        void subdividir() {
-            double mx = (x1 + x2) / 2.0, my = (y1 + y2) / 2.0;
-            nw = new Nodo(x1, y1, mx, my, profundidad + 1);
-            ne = new Nodo(mx, y1, x2, my, profundidad + 1);
-            sw = new Nodo(x1, my, mx, y2, profundidad + 1);
-            se = new Nodo(mx, my, x2, y2, profundidad + 1);
-            for (const auto& p : puntos) {
-                if (nw->contiene(p.x, p.y)) nw->puntos.push_back(p);
-                else if (ne->contiene(p.x, p.y)) ne->puntos.push_back(p);
-                else if (sw->contiene(p.x, p.y)) sw->puntos.push_back(p);
-                else se->puntos.push_back(p);
-            }
-            puntos.clear();
-            esHoja = false;
-        }
-    };
-
-    Nodo* raiz = nullptr;
-    double boundX1 = 0, boundY1 = 0, boundX2 = TAM_TABLERO, boundY2 = TAM_TABLERO;
-
-    bool insertar(Nodo* n, const PointQT& p) {
-        if (!n->contiene(p.x, p.y)) return false;
-        if (n->esHoja) {
-            if (static_cast<int>(n->puntos.size()) < CAPACIDAD || n->profundidad >= PROF_MAX) {
-                n->puntos.push_back(p);
-                return true;
-            }
-            n->subdividir();
-        }
-        if (n->nw->contiene(p.x, p.y)) return insertar(n->nw, p);
-        if (n->ne->contiene(p.x, p.y)) return insertar(n->ne, p);
-        if (n->sw->contiene(p.x, p.y)) return insertar(n->sw, p);
-        return insertar(n->se, p);
-    }
-
-    void consultarRango(Nodo* n, const RectQT& rango, std::vector<PointQT>& out) const {
-        if (!n) return;
-        RectQT nodoRect(n->x1, n->y1, n->x2 - n->x1, n->y2 - n->y1);
-        if (!nodoRect.intersecta(rango)) return;
-        if (n->esHoja) {
-            for (const auto& p : n->puntos)
-                if (rango.contiene(p)) out.push_back(p);
-            return;
-        }
-        consultarRango(n->nw, rango, out);
-        consultarRango(n->ne, rango, out);
-        consultarRango(n->sw, rango, out);
-        consultarRango(n->se, rango, out);
-    }
-
-public:
-    QuadTree(double x1, double y1, double x2, double y2)
-        : boundX1(x1), boundY1(y1), boundX2(x2), boundY2(y2) {
-        raiz = new Nodo(x1, y1, x2, y2, 0);
-    }
-
-    ~QuadTree() { delete raiz; }
-
-    void limpiar() {
-        delete raiz;
-        raiz = new Nodo(boundX1, boundY1, boundX2, boundY2, 0);
-    }
-
-    void reiniciar(double x1, double y1, double x2, double y2) {
-        boundX1 = x1; boundY1 = y1; boundX2 = x2; boundY2 = y2;
-        delete raiz;
-        raiz = new Nodo(x1, y1, x2, y2, 0);
-    }
-
-    bool insertar(double x, double y) { return insertar(raiz, PointQT(x, y)); }
-
-    void consultarRango(double x, double y, double w, double h, std::vector<PointQT>& out) const {
-        out.clear();
-        consultarRango(raiz, RectQT(x, y, w, h), out);
-    }
-
-    bool hayPuntosEnCelda(double cx, double cy) const {
-        std::vector<PointQT> res;
-        consultarRango(cx, cy, 1.0, 1.0, res);
-        return !res.empty();
-    }
-};
-
-enum Direccion { Arriba, Abajo, Izquierda, Derecha, Ninguna };
-enum TipoCelda { Vacia, Muro, Hielo, Uva, Platano, FrutaNormal, FrutaCongelada };
-enum TipoEnemigo { Normal, Especial };
-
-struct Posicion {
-    float x = 0, y = 0;
-    Posicion() = default;
-    Posicion(float _x, float _y) : x(_x), y(_y) {}
-    int celdaX() const { return static_cast<int>(std::round(x)); }
-    int celdaY() const { return static_cast<int>(std::round(y)); }
-};
-
-struct Jugador {
-    Posicion pos;
-    Direccion dir = Ninguna;
-    float velocidad = VEL_JUGADOR;
-    bool vivo = true;
-    int frutas_recogidas = 0;
-
-    void mover(Direccion d) {
-        dir = d;
-        switch (d) {
-            case Arriba:  pos.y -= velocidad; break;
-            case Abajo:   pos.y += velocidad; break;
-            case Izquierda: pos.x -= velocidad; break;
-            case Derecha:  pos.x += velocidad; break;
-            default: break;
-        }
-    }
-    void detener() { dir = Ninguna; }
-};
-
-struct Enemigo {
-    Posicion pos;
-    Direccion dir = Abajo;
-    TipoEnemigo tipo = Normal;
-    float velocidad = VEL_ENEMIGO_NORMAL;
-    bool vivo = true;
-    int ticksParaCambiar = 0;
-
-    Enemigo() = default;
-    Enemigo(float x, float y, TipoEnemigo t) : pos(x, y), tipo(t) {
-        velocidad = (t == Especial) ? VEL_ENEMIGO_ESPECIAL : VEL_ENEMIGO_NORMAL;
-    }
-    void mover() {
-        if (!vivo) return;
-        switch (dir) {
-            case Arriba:  pos.y -= velocidad; break;
-            case Abajo:   pos.y += velocidad; break;
-            case Izquierda: pos.x -= velocidad; break;
-            case Derecha:  pos.x += velocidad; break;
-            default: break;
-        }
-    }
-};
-
-struct Fruta {
-    Posicion pos;
-    TipoCelda tipoFruta = Uva;
-    bool recogida = false;
-    bool congelada = false;
-    Fruta() = default;
-    Fruta(float x, float y, TipoCelda t) : pos(x, y), tipoFruta(t) {}
-};
-
-class Mapa {
-    TipoCelda casilla[TAM_TABLERO][TAM_TABLERO];
-public:
-    void inicializar() {
-        for (int i = 0; i < TAM_TABLERO; i++)
-            for (int j = 0; j < TAM_TABLERO; j++)
-                casilla[i][j] = Vacia;
-        for (int k = 0; k < TAM_TABLERO; k++) {
-            casilla[0][k] = casilla[TAM_TABLERO - 1][k] = Muro;
-            casilla[k][0] = casilla[k][TAM_TABLERO - 1] = Muro;
-        }
-    }
-
-    void ponerMurosAleatorios() {
-        int celdasInterior = (TAM_TABLERO - 2) * (TAM_TABLERO - 2);
-        int numMuros = 8 + (QRandomGenerator::global()->bounded(10));
-        numMuros = std::min(numMuros, celdasInterior / 4);
-        int puestos = 0;
-        while (puestos < numMuros) {
-            int r = 1 + QRandomGenerator::global()->bounded(TAM_TABLERO - 2);
-            int c = 1 + QRandomGenerator::global()->bounded(TAM_TABLERO - 2);
-            if (casilla[r][c] == Vacia) {
-                casilla[r][c] = Muro;
-                puestos++;
-            }
-        }
-    }
-
-    TipoCelda obtenerCelda(int fila, int col) const {
-        if (fila < 0 || fila >= TAM_TABLERO || col < 0 || col >= TAM_TABLERO)
-            return Muro;
-        return casilla[fila][col];
-    }
-
-    void crearHielo(int fila, int col) {
-        if (fila >= 1 && fila < TAM_TABLERO - 1 && col >= 1 && col < TAM_TABLERO - 1 && casilla[fila][col] == Vacia)
-            casilla[fila][col] = Hielo;
-    }
-    void romperHielo(int fila, int col) {
-        if (fila >= 0 && fila < TAM_TABLERO && col >= 0 && col < TAM_TABLERO && casilla[fila][col] == Hielo)
-            casilla[fila][col] = Vacia;
-    }
-
-    bool sePuedePasar(int fila, int col) const {
-        TipoCelda t = obtenerCelda(fila, col);
-        return (t == Vacia || t == Uva || t == Platano);
-    }
-    bool puedePasarEspecial(int fila, int col) const {
-        if (fila < 0 || fila >= TAM_TABLERO || col < 0 || col >= TAM_TABLERO)
-            return false;
-        TipoCelda t = casilla[fila][col];
-        return (t == Vacia || t == Uva || t == Platano || t == Hielo);
-    }
-
-    bool celdaVaciaParaSpawn(int fila, int col) const {
-        return obtenerCelda(fila, col) == Vacia;
-    }
-
-    void ponerFrutas(Fruta* frutas, int& numFrutas, TipoCelda tipo, int cantidad) {
-        int colocadas = 0;
-        int intentos = 0;
-        while (colocadas < cantidad && intentos < 500) {
-            intentos++;
-            int r = 1 + QRandomGenerator::global()->bounded(TAM_TABLERO - 2);
-            int c = 1 + QRandomGenerator::global()->bounded(TAM_TABLERO - 2);
-            if (casilla[r][c] != Vacia) continue;
-            bool muyCerca = false;
-            for (int i = 0; i < numFrutas; i++) {
-                if (frutas[i].recogida) continue;
-                int fr = frutas[i].pos.celdaY(), fc = frutas[i].pos.celdaX();
-                if (std::abs(fr - r) <= 1 && std::abs(fc - c) <= 1) { muyCerca = true; break; }
-            }
-            if (!muyCerca) {
-                frutas[numFrutas++] = Fruta(static_cast<float>(c), static_cast<float>(r), tipo);
-                casilla[r][c] = tipo;
-                colocadas++;
-            }
-        }
-    }
-};
-
-class LogicaEnemigo {
-public:
-    static bool hayFrutaCongeladaEn(int fila, int col, const Fruta* frutas, int numFrutas) {
-        for (int i = 0; i < numFrutas; i++) {
-            if (frutas[i].recogida) continue;
-            if (frutas[i].pos.celdaY() == fila && frutas[i].pos.celdaX() == col && frutas[i].congelada)
-                return true;
-        }
-        return false;
-    }
-
-    static bool puedePasarCelda(int fila, int col, const Enemigo& e, const Mapa& mapa, const Fruta* frutas, int numFrutas) {
-        bool mapaOk = (e.tipo == Especial) ? mapa.puedePasarEspecial(fila, col) : mapa.sePuedePasar(fila, col);
-        return mapaOk && !hayFrutaCongeladaEn(fila, col, frutas, numFrutas);
-    }
-
-    static void elegirDireccionHaciaJugador(Enemigo& e, const Jugador& jug, const Mapa& mapa, const Fruta* frutas, int numFrutas) {
-        int jr = jug.pos.celdaY(), jc = jug.pos.celdaX();
-        int er = e.pos.celdaY(), ec = e.pos.celdaX();
-        int dr = jr - er, dc = jc - ec;
-        Direccion preferida = Ninguna;
-        if (std::abs(dr) >= std::abs(dc)) {
-            preferida = (dr > 0) ? Abajo : Arriba;
-        } else {
-            preferida = (dc > 0) ? Derecha : Izquierda;
-        }
-        int nr = er, nc = ec;
-        switch (preferida) {
-            case Arriba: nr--; break;
-            case Abajo: nr++; break;
-            case Izquierda: nc--; break;
-            case Derecha: nc++; break;
-            default: break;
-        }
-        bool puede = puedePasarCelda(nr, nc, e, mapa, frutas, numFrutas);
-        if (puede) {
-            e.dir = preferida;
-            return;
-        }
-        Direccion otra = (std::abs(dr) >= std::abs(dc)) ? (dc > 0 ? Derecha : Izquierda) : (dr > 0 ? Abajo : Arriba);
-        nr = er; nc = ec;
-        switch (otra) {
-            case Arriba: nr--; break;
-            case Abajo: nr++; break;
-            case Izquierda: nc--; break;
-            case Derecha: nc++; break;
-            default: break;
-        }
-        puede = puedePasarCelda(nr, nc, e, mapa, frutas, numFrutas);
-        if (puede) { e.dir = otra; return; }
-        int d = QRandomGenerator::global()->bounded(4);
-        e.dir = static_cast<Direccion>(d);
-    }
-
-    static void actualizar(Enemigo& e, const Jugador& jug, Mapa& mapa, const Fruta* frutas, int numFrutas) {
-        if (!e.vivo) return;
-        e.ticksParaCambiar--;
-        if (e.ticksParaCambiar <= 0) {
-            e.ticksParaCambiar = 5 + QRandomGenerator::global()->bounded(15);
-            if (QRandomGenerator::global()->generateDouble() < PROB_PERSECUCION)
-                elegirDireccionHaciaJugador(e, jug, mapa, frutas, numFrutas);
-            else {
-                int d = QRandomGenerator::global()->bounded(4);
-                e.dir = static_cast<Direccion>(d);
-            }
-        }
-        Posicion ant = e.pos;
-        e.mover();
-        int nr = e.pos.celdaY(), nc = e.pos.celdaX();
-        bool pasar = puedePasarCelda(nr, nc, e, mapa, frutas, numFrutas);
-        if (!pasar) {
-            e.pos = ant;
-            int d = QRandomGenerator::global()->bounded(4);
-            e.dir = static_cast<Direccion>(d);
-        }
-    }
-
-    static bool colisionConJugador(const Enemigo& e, const Jugador& jug) {
-        if (!jug.vivo) return false;
-        return e.pos.celdaX() == jug.pos.celdaX() && e.pos.celdaY() == jug.pos.celdaY();
-    }
-};
-
-class CongelarDescongelar {
-public:
-    static void congelar(Jugador& jug, Mapa& mapa, Enemigo* enemigos, int numEnemigos, Fruta* frutas, int numFrutas) {
-        int jr = jug.pos.celdaY(), jc = jug.pos.celdaX();
-        int dr = 0, dc = 0;
-        switch (jug.dir) {
-            case Arriba: dr = -1; break;
-            case Abajo: dr = 1; break;
-            case Izquierda: dc = -1; break;
-            case Derecha: dc = 1; break;
-            default: dr = -1; break;
-        }
-        int r = jr + dr, c = jc + dc;
-        while (r >= 1 && r < TAM_TABLERO - 1 && c >= 1 && c < TAM_TABLERO - 1) {
-            if (mapa.obtenerCelda(r, c) == Muro) break;
-            bool hayEnemigo = false;
-            for (int i = 0; i < numEnemigos; i++)
-                if (enemigos[i].vivo && enemigos[i].pos.celdaY() == r && enemigos[i].pos.celdaX() == c) { hayEnemigo = true; break; }
-            if (hayEnemigo) break;
-            for (int i = 0; i < numFrutas; i++)
-                if (!frutas[i].recogida && frutas[i].pos.celdaY() == r && frutas[i].pos.celdaX() == c)
-                    frutas[i].congelada = true;
-            if (mapa.obtenerCelda(r, c) == Vacia) mapa.crearHielo(r, c);
-            r += dr; c += dc;
-        }
-    }
-
-    static void descongelar(Jugador& jug, Mapa& mapa, Enemigo*, int, Fruta* frutas, int numFrutas) {
-        int jr = jug.pos.celdaY(), jc = jug.pos.celdaX();
-        int dr = 0, dc = 0;
-        switch (jug.dir) {
-            case Arriba: dr = -1; break;
-            case Abajo: dr = 1; break;
-            case Izquierda: dc = -1; break;
-            case Derecha: dc = 1; break;
-            default: dr = -1; break;
-        }
-        int r = jr + dr, c = jc + dc;
-        while (r >= 1 && r < TAM_TABLERO - 1 && c >= 1 && c < TAM_TABLERO - 1) {
-            if (mapa.obtenerCelda(r, c) == Muro) break;
-            for (int i = 0; i < numFrutas; i++)
-                if (!frutas[i].recogida && frutas[i].pos.celdaY() == r && frutas[i].pos.celdaX() == c)
-                    frutas[i].congelada = false;
-            if (mapa.obtenerCelda(r, c) == Hielo) mapa.romperHielo(r, c);
-            r += dr; c += dc;
-        }
-    }
-};
-
-enum EstadoJuego { Menu, Jugando, Ganaste, Perdiste };
+#include "nucleo/DueloRed.h"
+#include "nucleo/Guardado.h"
+#include "nucleo/HiloSimulacion.h"
+#include "nucleo/Juego.h"
+#include "nucleo/PaqueteNiveles.h"
+#include "nucleo/Repeticion.h"
 
-class Juego {
-public:
-    EstadoJuego estado = Menu;
-    int nivel = 1;
-    Jugador jugador;
-    bool esBot = false;
-    Mapa mapa;
-    Enemigo enemigos[MAX_ENEMIGOS];
-    int numEnemigos = 0;
-    Fruta frutas[MAX_FRUTAS];
-    int numFrutas = 0;
-    int uvasRestantes = 0;
-    int platanosRestantes = 0;
-    QuadTree quadTreeEnemigos{0.0, 0.0, static_cast<double>(TAM_TABLERO), static_cast<double>(TAM_TABLERO)};
-    int ticksDesdeInicio = 0;
-    Direccion ultimaDirBot = Ninguna;
-    int pasosBloqueadoBot = 0;
-
-    void tickBot() {
-        if (!esBot || estado != Jugando || !jugador.vivo) return;
-
-        Posicion ant = jugador.pos;
-        if (pasosBloqueadoBot >= 2) {
-            int jr = ant.celdaY();
-            int jc = ant.celdaX();
-            Direccion dirs[4] = {Arriba, Abajo, Izquierda, Derecha};
-            for (int k = 0; k < 4; ++k) {
-                int r = QRandomGenerator::global()->bounded(4);
-                std::swap(dirs[k], dirs[r]);
-            }
-            for (Direccion d : dirs) {
-                int nr = jr, nc = jc;
-                switch (d) {
-                    case Arriba:    nr--; break;
-                    case Abajo:     nr++; break;
-                    case Izquierda: nc--; break;
-                    case Derecha:   nc++; break;
-                    default: break;
-                }
-                if (nr < 0 || nr >= TAM_TABLERO || nc < 0 || nc >= TAM_TABLERO) continue;
-                if (!mapa.sePuedePasar(nr, nc)) continue;
-                if (hayFrutaCongeladaEn(nr, nc)) continue;
-                moverJugador(d);
-                ultimaDirBot = d;
-                break;
-            }
-            } else {
-            int jr = jugador.pos.celdaY();
-            int jc = jugador.pos.celdaX();
-            int mejorIdx = -1;
-            int mejorDist = 1e9;
-            for (int i = 0; i < numFrutas; i++) {
-                if (frutas[i].recogida) continue;
-                int fr = frutas[i].pos.celdaY();
-                int fc = frutas[i].pos.celdaX();
-                int dist = std::abs(fr - jr) + std::abs(fc - jc);
-                if (dist < mejorDist) {
-                    mejorDist = dist;
-                    mejorIdx = i;
-                }
-            }
-            if (mejorIdx == -1) return;
-            int fr = frutas[mejorIdx].pos.celdaY();
-            int fc = frutas[mejorIdx].pos.celdaX();
-            int dr = fr - jr;
-            int dc = fc - jc;
-            Direccion d1 = Ninguna, d2 = Ninguna;
-            if (std::abs(dr) >= std::abs(dc)) {
-                d1 = (dr > 0) ? Abajo : Arriba;
-                if (dc != 0) d2 = (dc > 0) ? Derecha : Izquierda;
-            } else {
-                d1 = (dc > 0) ? Derecha : Izquierda;
-                if (dr != 0) d2 = (dr > 0) ? Abajo : Arriba;
-            }
-
-            if (d1 != Ninguna) {
-                moverJugador(d1);
-                if (jugador.pos.celdaX() == ant.celdaX() && jugador.pos.celdaY() == ant.celdaY() && d2 != Ninguna) {
-                    moverJugador(d2);
-                }
-            } else if (d2 != Ninguna) {
-                moverJugador(d2);
-            }
-            ultimaDirBot = jugador.dir;
-        }
-
-        int jr = jugador.pos.celdaY();
-        int jc = jugador.pos.celdaX();
-        if (jr == ant.celdaY() && jc == ant.celdaX()) {
-            pasosBloqueadoBot++;
-            if (pasosBloqueadoBot > 6) pasosBloqueadoBot = 6;
-        } else {
-            pasosBloqueadoBot = 0;
-        }
-    }
-
-    void iniciarNivel(int n) {
-        nivel = n;
-        estado = Jugando;
-        jugador.vivo = true;
-        jugador.dir = Ninguna;
-        jugador.frutas_recogidas = 0;
-        ticksDesdeInicio = 0;
-        pasosBloqueadoBot = 0;
-        ultimaDirBot = Ninguna;
-        mapa.inicializar();
-        mapa.ponerMurosAleatorios();
-        int pr = TAM_TABLERO / 2, pc = TAM_TABLERO / 2;
-        if (mapa.obtenerCelda(pr, pc) != Vacia) {
-            for (int d = 1; d < TAM_TABLERO/2; d++) {
-                if (mapa.obtenerCelda(pr - d, pc) == Vacia) { pr -= d; break; }
-                if (mapa.obtenerCelda(pr + d, pc) == Vacia) { pr += d; break; }
-                if (mapa.obtenerCelda(pr, pc - d) == Vacia) { pc -= d; break; }
-                if (mapa.obtenerCelda(pr, pc + d) == Vacia) { pc += d; break; }
-            }
-        }
-        jugador.pos = Posicion(static_cast<float>(pc), static_cast<float>(pr));
-        numEnemigos = std::min(nivel, MAX_ENEMIGOS);
-        for (int i = 0; i < numEnemigos; i++) {
-            int er, ec;
-            int intentos = 0;
-            do {
-                // filas altas del mapa (1..3) para evitar spawnear junto al jugador central
-                er = 1 + QRandomGenerator::global()->bounded(std::min(3, TAM_TABLERO - 2));
-                ec = 1 + QRandomGenerator::global()->bounded(TAM_TABLERO - 2);
-                if (++intentos > 200) break;
-            } while (!mapa.celdaVaciaParaSpawn(er, ec) ||
-                     ocupadoPorOtroEnemigo(ec, er, i) ||
-                     (std::abs(er - pr) + std::abs(ec - pc) <= 2));
-            enemigos[i] = Enemigo(static_cast<float>(ec), static_cast<float>(er), (i == numEnemigos - 1 && nivel >= 3) ? Especial : Normal);
-            enemigos[i].ticksParaCambiar = QRandomGenerator::global()->bounded(10);
-        }
-
-        numFrutas = 0;
-        int cantUvas = 5 + nivel * 2;
-        cantUvas = std::min(cantUvas, 15);
-        mapa.ponerFrutas(frutas, numFrutas, Uva, cantUvas);
-        uvasRestantes = numFrutas;
-        platanosRestantes = 0;
-        quadTreeEnemigos.reiniciar(0.0, 0.0, static_cast<double>(TAM_TABLERO), static_cast<double>(TAM_TABLERO));
-    }
-
-    bool ocupadoPorOtroEnemigo(int c, int r, int excepto) const {
-        for (int i = 0; i < numEnemigos; i++) {
-            if (i == excepto) continue;
-            if (enemigos[i].pos.celdaX() == c && enemigos[i].pos.celdaY() == r) return true;
-        }
-        return false;
-    }
-
-    bool hayFrutaCongeladaEn(int fila, int col) const {
-        for (int i = 0; i < numFrutas; i++) {
-            if (frutas[i].recogida) continue;
-            if (frutas[i].pos.celdaY() == fila && frutas[i].pos.celdaX() == col && frutas[i].congelada)
-                return true;
-        }
-        return false;
-    }
-
-    void moverJugador(Direccion d) {
-        if (estado != Jugando || !jugador.vivo) return;
-        Posicion ant = jugador.pos;
-        jugador.mover(d);
-        int fr = jugador.pos.celdaY(), fc = jugador.pos.celdaX();
-        TipoCelda t = mapa.obtenerCelda(fr, fc);
-        if (t == Muro || t == Hielo || hayFrutaCongeladaEn(fr, fc)) jugador.pos = ant;
-    }
-
-    void verFrutas() {
-        int pr = jugador.pos.celdaY(), pc = jugador.pos.celdaX();
-        for (int i = 0; i < numFrutas; i++) {
-            if (frutas[i].recogida || frutas[i].congelada) continue;
-            if (frutas[i].pos.celdaY() == pr && frutas[i].pos.celdaX() == pc) {
-                frutas[i].recogida = true;
-                jugador.frutas_recogidas++;
-                if (frutas[i].tipoFruta == Uva) uvasRestantes--;
-                else if (frutas[i].tipoFruta == Platano) platanosRestantes--;
-            }
-        }
-    }
-
-    void verSiGano() {
-        if (uvasRestantes == 0 && platanosRestantes == 0) estado = Ganaste;
-    }
-
-    void actualizar() {
-        if (estado != Jugando) return;
-        ticksDesdeInicio++;
-        if (esBot) tickBot();
-        for (int i = 0; i < numEnemigos; i++) {
-            if (!enemigos[i].vivo) continue;
-            LogicaEnemigo::actualizar(enemigos[i], jugador, mapa, frutas, numFrutas);
-        }
-        quadTreeEnemigos.limpiar();
-        for (int i = 0; i < numEnemigos; i++) {
-            if (!enemigos[i].vivo) continue;
-            double ex = enemigos[i].pos.celdaX() + 0.5, ey = enemigos[i].pos.celdaY() + 0.5;
-            quadTreeEnemigos.insertar(ex, ey);
-        }
-        int jx = jugador.pos.celdaX(), jy = jugador.pos.celdaY();
-        if (ticksDesdeInicio > 1 &&
-            quadTreeEnemigos.hayPuntosEnCelda(static_cast<double>(jx), static_cast<double>(jy))) {
-            jugador.vivo = false;
-            estado = Perdiste;
-            return;
-        }
-        verFrutas();
-        verSiGano();
-    }
-
-    void congelar() { CongelarDescongelar::congelar(jugador, mapa, enemigos, numEnemigos, frutas, numFrutas); }
-    void descongelar() { CongelarDescongelar::descongelar(jugador, mapa, enemigos, numEnemigos, frutas, numFrutas); }
-};
+using Instantanea = HiloSimulacion::Instantanea;
 
 static QString rutaSprites() {
     QDir d(QCoreApplication::applicationDirPath());
@@ -664,19 +54,83 @@ static QString rutaSprites() {
     return r1;
 }
 
+// Carpeta de las partidas grabadas (.icr), junto al ejecutable
+static QString rutaRepeticiones() {
+    return QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("repeticiones");
+}
+
+// Partida guardada con F5 (una sola, se sobrescribe)
+static QString rutaGuardado() {
+    return QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("partida.icsv");
+}
+
+// Niveles ya generados y comprobados (herramientas/empaquetador), junto al
+// ejecutable. Se proyecta la primera vez que se pide; si no está, cada nivel
+// se genera con una semilla al azar como siempre.
+static const PaqueteNiveles& paqueteNiveles() {
+    static PaqueteNiveles paquete;
+    static bool intentado = false;
+    if (!intentado) {
+        intentado = true;
+        QString ruta = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("niveles.icpn");
+        if (paquete.abrir(ruta.toStdString()))
+            qDebug() << "[Niveles]" << paquete.total() << "niveles en" << ruta;
+    }
+    return paquete;
+}
+
+// Tiempo desde que arrancó main(), para medir el arranque
+static QElapsedTimer& relojArranque() {
+    static QElapsedTimer reloj;
+    return reloj;
+}
+
+// Cuadro de animación: índice en AtlasSprites (-1 si no se cargó)
+using Cuadro = int;
+const Cuadro SIN_CUADRO = -1;
+
+// Cuándo se decodifica un grupo de cuadros: al arrancar, de fondo tras los
+// primeros, o solo cuando se dibuja alguno por primera vez
+enum PrioridadCarga { CargaInmediata, CargaFondo, CargaPerezosa };
+
+// Cuadros reservados por las animaciones, sin decodificar todavía: ruta de
+// cada uno y tanda a la que pertenece. AtlasSprites decodifica cada tanda
+// entera en un hilo aparte.
+struct RegistroCuadros {
+    struct Tanda {
+        PrioridadCarga prioridad;
+        QVector<Cuadro> cuadros;
+    };
+    QVector<QString> rutas; // por Cuadro
+    QVector<int> tandaDe;   // por Cuadro
+    QVector<Tanda> tandas;
+
+    // Los cuadros anotados a partir de aquí van a una tanda nueva
+    void abrirTanda(PrioridadCarga p) { tandas.append({p, {}}); }
+
+    // Comprobar que el archivo existe es barato; lo caro es decodificarlo
+    Cuadro anotar(const QString& ruta) {
+        if (!QFileInfo::exists(ruta)) return SIN_CUADRO;
+        Cuadro c = rutas.size();
+        rutas.append(ruta);
+        tandaDe.append(tandas.size() - 1);
+        tandas.last().cuadros.append(c);
+        return c;
+    }
+};
 
 class AnimacionJugador {
 public:
     enum Tipo { Idle, Caminar, Congelar, RomperHielo, Rip, Ganar };
 
-    QVector<QPixmap> quieto;           // 0-1
-    QVector<QVector<QPixmap>> caminar; // [dir][0-7]: arriba=0, abajo=1, izquierda=2, derecha=3
-    QVector<QVector<QPixmap>> hacerhielo; // [dir][0-9]
-    QVector<QPixmap> romperhielo;      // 2-9
-    QVector<QPixmap> rip;              // 0-12
-    QVector<QPixmap> ganar;            // 0-5
+    QVector<Cuadro> quieto;           // 0-1
+    QVector<QVector<Cuadro>> caminar; // [dir][0-7]: arriba=0, abajo=1, izquierda=2, derecha=3
+    QVector<QVector<Cuadro>> hacerhielo; // [dir][0-9]
+    QVector<Cuadro> romperhielo;      // 2-9
+    QVector<Cuadro> rip;              // 0-12
+    QVector<Cuadro> ganar;            // 0-5
 
-    bool cargar(const QString& base) {
+    bool cargar(const QString& base, RegistroCuadros& reg) {
         qDebug() << "[Sprites] Buscando en:" << base;
         QDir b(base);
         if (!b.exists()) {
@@ -684,15 +138,16 @@ public:
             return false;
         }
 
+        // Quieto y caminar se ven nada más empezar; congelar poco después
+        reg.abrirTanda(CargaInmediata);
         for (int i = 0; i <= 1; i++) {
             QString ruta = QDir(base).absoluteFilePath("quieto/" + QString::number(i) + ".png");
-            QImage img(ruta);
-            if (img.isNull()) {
-                qDebug() << "[Sprites] ERROR cargando:" << ruta;
-                qDebug() << "[Sprites] QImageReader error:" << QImageReader(ruta).errorString();
+            Cuadro c = reg.anotar(ruta);
+            if (c == SIN_CUADRO) {
+                qDebug() << "[Sprites] ERROR: no existe" << ruta;
                 return false;
             }
-            quieto.append(QPixmap::fromImage(img));
+            quieto.append(c);
         }
 
         const char* dirs[] = {"abajo","arriba","derecha","izquierda"};
@@ -701,45 +156,50 @@ public:
             QString carpeta = QDir(base).absoluteFilePath(QString("caminar/") + dirs[d]);
             for (int i = 0; i <= 7; i++) {
                 QString ruta = QDir(carpeta).absoluteFilePath(QString::number(i) + ".png");
-                QImage img(ruta);
-                if (img.isNull()) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
-                caminar[d].append(QPixmap::fromImage(img));
+                Cuadro c = reg.anotar(ruta);
+                if (c == SIN_CUADRO) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
+                caminar[d].append(c);
             }
         }
 
+        reg.abrirTanda(CargaFondo);
         const int hacerhieloFrames[] = {10, 10, 8, 8};
         hacerhielo.resize(4);
         for (int d = 0; d < 4; d++) {
             QString carpeta = QDir(base).absoluteFilePath(QString("hacerhielo/") + dirs[d]);
             for (int i = 0; i < hacerhieloFrames[d]; i++) {
                 QString ruta = QDir(carpeta).absoluteFilePath(QString::number(i) + ".png");
-                QImage img(ruta);
-                if (img.isNull()) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
-                hacerhielo[d].append(QPixmap::fromImage(img));
+                Cuadro c = reg.anotar(ruta);
+                if (c == SIN_CUADRO) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
+                hacerhielo[d].append(c);
             }
         }
 
+        // Romper hielo, morir y ganar esperan a usarse por primera vez
+        reg.abrirTanda(CargaPerezosa);
         for (int i = 2; i <= 9; i++) {
             QString ruta = QDir(base).absoluteFilePath("romperhielo/" + QString::number(i) + ".png");
-            QImage img(ruta);
-            if (img.isNull()) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
-            romperhielo.append(QPixmap::fromImage(img));
+            Cuadro c = reg.anotar(ruta);
+            if (c == SIN_CUADRO) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
+            romperhielo.append(c);
         }
 
+        reg.abrirTanda(CargaPerezosa);
         for (int i = 0; i <= 12; i++) {
             QString ruta = QDir(base).absoluteFilePath("rip/" + QString::number(i) + ".png");
-            QImage img(ruta);
-            if (img.isNull()) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
-            rip.append(QPixmap::fromImage(img));
+            Cuadro c = reg.anotar(ruta);
+            if (c == SIN_CUADRO) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
+            rip.append(c);
         }
 
+        reg.abrirTanda(CargaPerezosa);
         for (int i = 0; i <= 5; i++) {
             QString ruta = QDir(base).absoluteFilePath("ganar/" + QString::number(i) + ".png");
-            QImage img(ruta);
-            if (img.isNull()) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
-            ganar.append(QPixmap::fromImage(img));
+            Cuadro c = reg.anotar(ruta);
+            if (c == SIN_CUADRO) { qDebug() << "[Sprites] ERROR:" << ruta; return false; }
+            ganar.append(c);
         }
-        qDebug() << "[Sprites] OK: Todos los sprites cargados";
+        qDebug() << "[Sprites] OK: Todos los sprites encontrados";
         return true;
     }
 
@@ -753,17 +213,17 @@ public:
         }
     }
 
-    QPixmap frame(Tipo t, Direccion dir, int frame) const {
+    Cuadro frame(Tipo t, Direccion dir, int frame) const {
         int di = dirToIndex(dir);
         switch (t) {
-            case Idle: return quieto.value(frame % quieto.size());
-            case Caminar: return caminar.value(di).value(frame % caminar[di].size());
-            case Congelar: return hacerhielo.value(di).value(std::min(frame, static_cast<int>(hacerhielo[di].size())-1));
-            case RomperHielo: return romperhielo.value(std::min(frame, static_cast<int>(romperhielo.size())-1));
-            case Rip: return rip.value(std::min(frame, static_cast<int>(rip.size())-1));
-            case Ganar: return ganar.value(std::min(frame, static_cast<int>(ganar.size())-1));
+            case Idle: return quieto.value(frame % quieto.size(), SIN_CUADRO);
+            case Caminar: return caminar.value(di).value(frame % caminar[di].size(), SIN_CUADRO);
+            case Congelar: return hacerhielo.value(di).value(std::min(frame, static_cast<int>(hacerhielo[di].size())-1), SIN_CUADRO);
+            case RomperHielo: return romperhielo.value(std::min(frame, static_cast<int>(romperhielo.size())-1), SIN_CUADRO);
+            case Rip: return rip.value(std::min(frame, static_cast<int>(rip.size())-1), SIN_CUADRO);
+            case Ganar: return ganar.value(std::min(frame, static_cast<int>(ganar.size())-1), SIN_CUADRO);
         }
-        return quieto.value(0);
+        return quieto.value(0, SIN_CUADRO);
     }
 
     int maxFrame(Tipo t, Direccion dir) const {
@@ -782,17 +242,17 @@ public:
 
 class AnimacionEnemigo {
 public:
-    QVector<QPixmap> quieto;
-    QVector<QVector<QPixmap>> caminar;
+    QVector<Cuadro> quieto;
+    QVector<QVector<Cuadro>> caminar;
 
-    bool cargar(const QString& base) {
+    bool cargar(const QString& base, RegistroCuadros& reg) {
         QString carpeta = QDir(base).absoluteFilePath("enemigos");
         if (!QDir(carpeta).exists()) return false;
 
-        QString rutaQuieto = QDir(carpeta).absoluteFilePath("quieto/0.png");
-        QImage imgQ(rutaQuieto);
-        if (imgQ.isNull()) return false;
-        quieto.append(QPixmap::fromImage(imgQ));
+        reg.abrirTanda(CargaInmediata);
+        Cuadro cq = reg.anotar(QDir(carpeta).absoluteFilePath("quieto/0.png"));
+        if (cq == SIN_CUADRO) return false;
+        quieto.append(cq);
 
         const char* dirs[] = {"abajo", "arriba", "derecha", "izquierda"};
         caminar.resize(4);
@@ -800,9 +260,9 @@ public:
             QString sub = QDir(carpeta).absoluteFilePath(dirs[d]);
             for (int i = 0; i <= 7; i++) {
                 QString ruta = QDir(sub).absoluteFilePath(QString::number(i) + ".png");
-                QImage img(ruta);
-                if (img.isNull()) return false;
-                caminar[d].append(QPixmap::fromImage(img));
+                Cuadro c = reg.anotar(ruta);
+                if (c == SIN_CUADRO) return false;
+                caminar[d].append(c);
             }
         }
         return true;
@@ -818,11 +278,11 @@ public:
         }
     }
 
-    QPixmap frame(Direccion dir, int frame, bool moviendo) const {
+    Cuadro frame(Direccion dir, int frame, bool moviendo) const {
         int di = dirToIndex(dir);
         if (moviendo && di >= 0 && di < caminar.size())
-            return caminar[di].value(frame % caminar[di].size());
-        return quieto.value(0);
+            return caminar[di].value(frame % caminar[di].size(), SIN_CUADRO);
+        return quieto.value(0, SIN_CUADRO);
     }
 
     int maxFrame(Direccion dir) const {
@@ -835,94 +295,608 @@ public:
 
 class AnimacionBloques {
 public:
-    QPixmap hielo, nieve, nieve2, bordes;
+    Cuadro hielo = SIN_CUADRO, nieve = SIN_CUADRO, nieve2 = SIN_CUADRO, bordes = SIN_CUADRO;
 
-    bool cargar(const QString& base) {
+    bool cargar(const QString& base, RegistroCuadros& reg) {
         QString carpeta = QDir(base).absoluteFilePath("bloques");
         if (!QDir(carpeta).exists()) return false;
-        QImage ih(QDir(carpeta).absoluteFilePath("hielo.png"));
-        QImage in1(QDir(carpeta).absoluteFilePath("nieve.png"));
-        QImage in2(QDir(carpeta).absoluteFilePath("nieve2.png"));
-        QImage ib(QDir(carpeta).absoluteFilePath("bordes.png"));
-        if (ih.isNull() || in1.isNull() || in2.isNull() || ib.isNull()) return false;
-        hielo = QPixmap::fromImage(ih);
-        nieve = QPixmap::fromImage(in1);
-        nieve2 = QPixmap::fromImage(in2);
-        bordes = QPixmap::fromImage(ib);
-        return true;
+        reg.abrirTanda(CargaInmediata);
+        hielo = reg.anotar(QDir(carpeta).absoluteFilePath("hielo.png"));
+        nieve = reg.anotar(QDir(carpeta).absoluteFilePath("nieve.png"));
+        nieve2 = reg.anotar(QDir(carpeta).absoluteFilePath("nieve2.png"));
+        bordes = reg.anotar(QDir(carpeta).absoluteFilePath("bordes.png"));
+        return hielo != SIN_CUADRO && nieve != SIN_CUADRO && nieve2 != SIN_CUADRO && bordes != SIN_CUADRO;
     }
 };
 
 class AnimacionFruta {
 public:
-    QPixmap sprite;
+    Cuadro sprite = SIN_CUADRO;
+
+    bool cargar(const QString& base, RegistroCuadros& reg) {
+        reg.abrirTanda(CargaInmediata);
+        sprite = reg.anotar(QDir(base).absoluteFilePath("frutas/0.png"));
+        return sprite != SIN_CUADRO;
+    }
+};
+
+// Todos los sprites del juego (jugador, enemigos, bloques y fruta) empaquetados
+// en hojas grandes, con el rectángulo de cada cuadro. Los PNG se decodifican
+// una sola vez por proceso y fuera del hilo de la interfaz: cada tanda del
+// registro se decodifica y empaqueta en el pool de hilos, y al terminar sus
+// hojas se pasan a QPixmap en el hilo de la interfaz. Hasta entonces sus
+// cuadros no son válidos y los tableros dibujan los círculos de siempre.
+// Cada WidgetTablero guarda el shared_ptr de compartido() y el atlas se libera
+// con el último tablero.
+class AtlasSprites : public std::enable_shared_from_this<AtlasSprites> {
+    static const int LADO_HOJA = 1024;
+    static const int MARGEN = 1; // evita que el suavizado mezcle cuadros vecinos
+
+    enum EstadoTanda { SinEmpezar, Cargando, Lista };
+
+    // Una tanda ya decodificada: sus hojas y, por cada cuadro de la tanda en
+    // orden, la hoja (-1 si no se pudo leer) y su rectángulo en ella
+    struct TandaDecodificada {
+        int tanda = 0;
+        QVector<QImage> hojas;
+        QVector<int> hojaDe;
+        QVector<QRect> rects;
+    };
+
+    RegistroCuadros registro;
+    QVector<EstadoTanda> estados; // por tanda
+    QVector<QPixmap> hojas;
+    QVector<int> hojaDe;  // por Cuadro, -1 mientras no esté cargado
+    QVector<QRect> rects; // por Cuadro
+
+    // Se ejecuta en un hilo del pool: solo QImage, nada de QPixmap.
+    // Empaquetado por estanterías: de más alto a más bajo, de izquierda a
+    // derecha, y una hoja nueva cuando la actual se llena.
+    static TandaDecodificada decodificar(int tanda, const QVector<QString>& rutas) {
+        TandaDecodificada d;
+        d.tanda = tanda;
+        QVector<QImage> imagenes;
+        for (const QString& r : rutas)
+            imagenes.append(QImage(r).convertToFormat(QImage::Format_ARGB32_Premultiplied));
+        QVector<int> orden;
+        for (int i = 0; i < imagenes.size(); i++)
+            if (!imagenes[i].isNull()) orden.append(i);
+        std::stable_sort(orden.begin(), orden.end(), [&](int a, int b) {
+            return imagenes[a].height() > imagenes[b].height();
+        });
+        d.hojaDe.fill(-1, imagenes.size());
+        d.rects.fill(QRect(), imagenes.size());
+        QVector<QSize> usado(1, QSize(0, 0)); // ancho y alto ocupados por hoja
+        int x = 0, y = 0, altoFila = 0;
+        for (int i : orden) {
+            QSize t = imagenes[i].size().boundedTo(QSize(LADO_HOJA, LADO_HOJA));
+            if (x + t.width() > LADO_HOJA) {
+                x = 0;
+                y += altoFila + MARGEN;
+                altoFila = 0;
+            }
+            if (y + t.height() > LADO_HOJA) {
+                usado.append(QSize(0, 0));
+                x = y = altoFila = 0;
+            }
+            d.hojaDe[i] = usado.size() - 1;
+            d.rects[i] = QRect(QPoint(x, y), t);
+            usado.last() = usado.last().expandedTo(QSize(x + t.width(), y + t.height()));
+            x += t.width() + MARGEN;
+            altoFila = std::max(altoFila, t.height());
+        }
+        for (int h = 0; h < usado.size(); h++) {
+            QImage img(usado[h].expandedTo(QSize(1, 1)), QImage::Format_ARGB32_Premultiplied);
+            img.fill(Qt::transparent);
+            QPainter p(&img);
+            p.setCompositionMode(QPainter::CompositionMode_Source);
+            for (int i : orden)
+                if (d.hojaDe[i] == h) p.drawImage(d.rects[i].topLeft(), imagenes[i], QRect(QPoint(0, 0), d.rects[i].size()));
+            p.end();
+            d.hojas.append(img);
+        }
+        return d;
+    }
+
+    void empezar(int t) {
+        estados[t] = Cargando;
+        QVector<QString> rutas;
+        for (Cuadro c : registro.tandas[t].cuadros) rutas.append(registro.rutas[c]);
+        // Las perezosas se piden cuando ya hacen falta: van por delante
+        int prioridad = registro.tandas[t].prioridad == CargaFondo ? 0 : 1;
+        std::weak_ptr<AtlasSprites> yo = weak_from_this();
+        QThreadPool::globalInstance()->start([yo, t, rutas]() {
+            TandaDecodificada d = decodificar(t, rutas);
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [yo, d]() {
+                if (std::shared_ptr<AtlasSprites> atlas = yo.lock()) atlas->instalar(d);
+            }, Qt::QueuedConnection);
+        }, prioridad);
+    }
+
+    void instalar(const TandaDecodificada& d) {
+        int base = hojas.size();
+        for (const QImage& img : d.hojas) hojas.append(QPixmap::fromImage(img));
+        const QVector<Cuadro>& cuadros = registro.tandas[d.tanda].cuadros;
+        for (int i = 0; i < cuadros.size(); i++) {
+            if (d.hojaDe[i] < 0) {
+                qDebug() << "[Sprites] ERROR cargando:" << registro.rutas[cuadros[i]];
+                continue;
+            }
+            hojaDe[cuadros[i]] = base + d.hojaDe[i];
+            rects[cuadros[i]] = d.rects[i];
+        }
+        estados[d.tanda] = Lista;
+        qDebug() << "[Sprites] Tanda" << d.tanda << "lista (" << cuadros.size() << "cuadros) a los"
+                 << relojArranque().elapsed() << "ms del arranque";
+    }
+
+public:
+    AnimacionJugador jugador;
+    bool jugadorCargado = false;
+    AnimacionEnemigo enemigo;
+    bool enemigoCargado = false;
+    AnimacionFruta fruta;
+    bool frutaCargada = false;
+    AnimacionBloques bloques;
+    bool bloquesCargados = false;
+
+    // Reserva los cuadros y lanza las tandas no perezosas; no espera a nada.
+    // Los ...Cargado dicen si los archivos existen, no si ya se decodificaron.
+    void cargar(const QString& base) {
+        jugadorCargado = jugador.cargar(base, registro);
+        enemigoCargado = enemigo.cargar(base, registro);
+        frutaCargada = fruta.cargar(base, registro);
+        bloquesCargados = bloques.cargar(base, registro);
+        hojaDe.fill(-1, registro.rutas.size());
+        rects.fill(QRect(), registro.rutas.size());
+        estados.fill(SinEmpezar, registro.tandas.size());
+        for (int t = 0; t < registro.tandas.size(); t++)
+            if (registro.tandas[t].prioridad != CargaPerezosa) empezar(t);
+    }
+
+    // Empieza a cargar la tanda de c si todavía nadie la pidió
+    void pedir(Cuadro c) {
+        if (c < 0 || c >= hojaDe.size()) return;
+        int t = registro.tandaDe[c];
+        if (estados[t] == SinEmpezar) empezar(t);
+    }
+
+    bool valido(Cuadro c) const { return c >= 0 && c < hojaDe.size() && hojaDe[c] >= 0; }
+    QSize tam(Cuadro c) const { return valido(c) ? rects[c].size() : QSize(); }
+    void dibujar(QPainter& p, const QRect& dest, Cuadro c) const {
+        if (valido(c)) p.drawPixmap(dest, hojas[hojaDe[c]], rects[c]);
+    }
+
+    static std::shared_ptr<AtlasSprites> compartido() {
+        static std::weak_ptr<AtlasSprites> vivo;
+        std::shared_ptr<AtlasSprites> atlas = vivo.lock();
+        if (!atlas) {
+            atlas = std::make_shared<AtlasSprites>();
+            atlas->cargar(rutaSprites());
+            vivo = atlas;
+        }
+        return atlas;
+    }
+};
+
+// Capa estática del tablero (muros, nieve y hielo) ya pintada al tamaño de
+// celda actual. Se repinta entera al cambiar el lado, la escala de pantalla o
+// el nivel; si no, solo las casillas que el Mapa anotó como cambiadas desde
+// el último frame, y un frame sin cambios no repinta nada.
+class CapaTablero {
+    QPixmap pm;
+    int ladoPx = 0;
+    qreal escala = 0;
+    const AtlasSprites* bloquesPintados = nullptr;
+    uint32_t generacion = 0;
+    uint64_t version = 0;
+    TipoCelda pintadas[TAM_TABLERO][TAM_TABLERO] = {};
+
+    static TipoCelda tipoCapa(TipoCelda t) { return (t == Muro || t == Hielo) ? t : Vacia; }
 
-    bool cargar(const QString& base) {
-        QString ruta = QDir(base).absoluteFilePath("frutas/0.png");
-        QImage img(ruta);
-        if (img.isNull()) return false;
-        sprite = QPixmap::fromImage(img);
+public:
+    static QColor colorFondo() { return QColor(0x2a, 0x26, 0x35); }
+
+    static void dibujarCelda(QPainter& p, const QRect& rect, TipoCelda t, int r, int c, const AtlasSprites* bloques) {
+        if (bloques && bloques->valido(bloques->bloques.bordes)) {
+            const AnimacionBloques& b = bloques->bloques;
+            if (t == Muro) {
+                bloques->dibujar(p, rect, b.bordes);
+            } else if (t == Hielo) {
+                bloques->dibujar(p, rect, b.hielo);
+            } else {
+                bloques->dibujar(p, rect, ((r + c) % 2 == 0) ? b.nieve : b.nieve2);
+            }
+        } else {
+            if (t == Muro) {
+                p.fillRect(rect, QColor(72, 65, 85));
+                p.setPen(QColor(50, 45, 60));
+                for (int b = 0; b < 2; b++) p.drawRect(rect.adjusted(b, b, -b, -b));
+                p.setPen(QColor(95, 88, 110));
+                p.drawLine(rect.left(), rect.top(), rect.right(), rect.top());
+                p.drawLine(rect.left(), rect.top(), rect.left(), rect.bottom());
+            } else if (t == Hielo) {
+                QLinearGradient grad(rect.topLeft(), rect.bottomRight());
+                grad.setColorAt(0, QColor(200, 235, 255));
+                grad.setColorAt(1, QColor(150, 205, 245));
+                p.fillRect(rect, grad);
+                p.setPen(QColor(100, 160, 210));
+                p.drawRect(rect);
+            } else {
+                QLinearGradient grad(rect.topLeft(), rect.bottomRight());
+                grad.setColorAt(0, QColor(252, 250, 245));
+                grad.setColorAt(1, QColor(238, 232, 220));
+                p.fillRect(rect, grad);
+                p.setPen(QColor(210, 202, 190));
+                p.drawRect(rect);
+            }
+        }
+    }
+
+    // El siguiente actualizar() repinta entero. Hace falta cuando el Mapa se
+    // sustituye por otro que puede traer la misma generación y versión (una
+    // partida cargada), porque entonces no se nota el cambio.
+    void invalidar() { pm = QPixmap(); }
+
+    // bloques es nullptr si los sprites de bloques no están cargados
+    const QPixmap& actualizar(const Mapa& m, int lado, qreal dpr, const AtlasSprites* bloques) {
+        bool completa = pm.isNull() || lado != ladoPx || dpr != escala || bloques != bloquesPintados ||
+                        m.generacion() != generacion;
+        if (!completa && m.version() == version) return pm;
+
+        if (completa) {
+            ladoPx = lado;
+            escala = dpr;
+            bloquesPintados = bloques;
+            pm = QPixmap(QSize(TAM_TABLERO * lado, TAM_TABLERO * lado) * dpr);
+            pm.setDevicePixelRatio(dpr);
+            pm.fill(colorFondo());
+        }
+        QPainter p(&pm);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        auto repintar = [&](int r, int c) {
+            TipoCelda t = tipoCapa(m.obtenerCelda(r, c));
+            if (!completa && t == pintadas[r][c]) return;
+            pintadas[r][c] = t;
+            p.fillRect(QRect(c * lado, r * lado, lado, lado), colorFondo());
+            dibujarCelda(p, QRect(c * lado + 2, r * lado + 2, lado - 3, lado - 3), t, r, c, bloques);
+        };
+        // Si el registro de cambios ya no llega hasta la última versión pintada,
+        // se comparan todas las casillas
+        if (completa || !m.paraCadaCambioDesde(version, repintar))
+            for (int r = 0; r < TAM_TABLERO; r++)
+                for (int c = 0; c < TAM_TABLERO; c++) repintar(r, c);
+        generacion = m.generacion();
+        version = m.version();
+        return pm;
+    }
+};
+
+// Cuadros del atlas ya escalados al lado de celda y a la escala de pantalla
+// actuales, para copiarlos 1:1 sin remuestrear en cada frame. Cada cuadro se
+// escala la primera vez que se dibuja con ese lado; al cambiar el lado o la
+// escala se tira todo. La fruta congelada tiene su propia variante ya teñida.
+class CacheSprites {
+    AtlasSprites* atlas = nullptr;
+    int ladoPx = 0;
+    qreal escala = 0;
+    QVector<QPixmap> normales;   // por Cuadro
+    QVector<QPixmap> congelados; // por Cuadro, con el tinte de fruta congelada
+
+    QPixmap escalar(Cuadro c, int tope, bool congelado) const {
+        QSize t = atlas->tam(c).boundedTo(QSize(tope, tope));
+        if (t.isEmpty()) return QPixmap();
+        QPixmap pm(t * escala);
+        pm.setDevicePixelRatio(escala);
+        pm.fill(Qt::transparent);
+        QPainter p(&pm);
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        atlas->dibujar(p, QRect(QPoint(0, 0), t), c);
+        // Overlay azul para fruta congelada (se distingue de la normal)
+        if (congelado) p.fillRect(QRect(QPoint(0, 0), t), QColor(150, 210, 255, 140));
+        return pm;
+    }
+
+public:
+    void preparar(AtlasSprites* a, int lado, qreal dpr) {
+        if (a == atlas && lado == ladoPx && dpr == escala) return;
+        atlas = a;
+        ladoPx = lado;
+        escala = dpr;
+        normales.clear();
+        congelados.clear();
+    }
+
+    // Cuadro c escalado para que no pase de tope x tope (nulo si no existe o
+    // aún no se ha cargado, y entonces lo pide al atlas). Cada cuadro se
+    // dibuja siempre con el mismo tope para un lado dado.
+    const QPixmap& sprite(Cuadro c, int tope, bool congelado = false) {
+        static const QPixmap nulo;
+        if (!atlas) return nulo;
+        if (!atlas->valido(c)) {
+            atlas->pedir(c);
+            return nulo;
+        }
+        QVector<QPixmap>& v = congelado ? congelados : normales;
+        if (v.size() <= c) v.resize(c + 1);
+        if (v[c].isNull()) v[c] = escalar(c, tope, congelado);
+        return v[c];
+    }
+
+    // Centrado en (x, y); false si no hay nada que dibujar
+    bool dibujar(QPainter& p, int x, int y, Cuadro c, int tope, bool congelado = false) {
+        const QPixmap& pm = sprite(c, tope, congelado);
+        if (pm.isNull()) return false;
+        QSize t = atlas->tam(c).boundedTo(QSize(tope, tope));
+        p.drawPixmap(QPoint(x - t.width() / 2, y - t.height() / 2), pm);
         return true;
     }
 };
 
+// Un extremo del duelo 1 vs 1 contra otro proceso por UDP. El anfitrión
+// escucha en su puerto y contesta a quien le salude; el invitado saluda a
+// HOST:PUERTO desde un puerto cualquiera. Las dos partidas se simulan aquí
+// mismo con DueloRed en el hilo de la interfaz, un avance por frame: con las
+// vueltas atrás no compensa mandarlas a HiloSimulacion. Con latenciaMs > 0
+// cada datagrama que sale espera ese tiempo antes de mandarse, para probar
+// en localhost como si hubiera una red de verdad por medio.
+class PartidaRed {
+    QUdpSocket socket;
+    QHostAddress destino;
+    quint16 puertoDestino = 0;
+    bool anfitrion;
+    quint16 puertoLocal;
+    EnlaceSimulado salida;
+    Juego* local;
+    DueloRed duelo;
+
+public:
+    PartidaRed(Juego* juegoLocal, Juego* juegoRemoto, bool esAnfitrion, const QHostAddress& host, quint16 puerto,
+               int latenciaMs, const DueloRed::Partida& p)
+        : destino(host),
+          puertoDestino(esAnfitrion ? 0 : puerto),
+          anfitrion(esAnfitrion),
+          puertoLocal(esAnfitrion ? puerto : 0),
+          salida(static_cast<int64_t>(latenciaMs) * 1000000),
+          local(juegoLocal),
+          duelo(juegoLocal, juegoRemoto, esAnfitrion, p) {}
+
+    bool abrir() {
+        if (socket.bind(QHostAddress(QHostAddress::AnyIPv4), puertoLocal)) return true;
+        qWarning() << "[Red] No se pudo abrir el puerto" << puertoLocal << socket.errorString();
+        return false;
+    }
+
+    bool esAnfitrion() const { return anfitrion; }
+    const Juego* juegoLocal() const { return local; }
+    const DueloRed& dueloRed() const { return duelo; }
+    bool ordenLocal(const Orden& o) { return duelo.ordenLocal(o); }
+
+    // Lee lo que haya llegado, avanza el duelo hasta 'ahoraNs' y manda lo suyo;
+    // devuelve los ticks avanzados
+    int avanzar(int64_t ahoraNs) {
+        while (socket.hasPendingDatagrams()) {
+            QNetworkDatagram d = socket.receiveDatagram();
+            // El anfitrión contesta a la dirección del primero que le habla
+            if (anfitrion && puertoDestino == 0 && d.senderPort() > 0) {
+                destino = d.senderAddress();
+                puertoDestino = static_cast<quint16>(d.senderPort());
+            }
+            QByteArray datos = d.data();
+            duelo.recibir(reinterpret_cast<const uint8_t*>(datos.constData()), static_cast<size_t>(datos.size()),
+                          ahoraNs);
+        }
+        int pasos = duelo.avanzar(ahoraNs, [&](std::vector<uint8_t> b) { salida.meter(std::move(b), ahoraNs); });
+        salida.sacarListos(ahoraNs, [&](const std::vector<uint8_t>& b) {
+            if (puertoDestino == 0) return;
+            socket.writeDatagram(reinterpret_cast<const char*>(b.data()), static_cast<qint64>(b.size()), destino,
+                                 puertoDestino);
+        });
+        return pasos;
+    }
+};
+
+class WidgetTablero;
+
+// Marca el ritmo de uno o varios tableros. La lógica de todos sus juegos
+// corre en un solo HiloSimulacion, a pasos fijos y todos en el mismo paso
+// (en el 1 vs 1 los dos van siempre por el mismo tick). En la interfaz queda
+// un temporizador a la frecuencia de la pantalla que recoge la última
+// instantánea de cada juego, avanza las animaciones y pide un repintado de
+// todos en el mismo frame, que Qt pinta en una sola pasada.
+//
+// En el duelo en red no hay hilo: cada frame avanza la PartidaRed y copia
+// las dos partidas a sus instantáneas.
+class RelojJuego {
+    // Cuadros de animación de los sprites por segundo, aparte de la lógica
+    static const int CUADROS_ANIM_POR_SEGUNDO = 5;
+    // Tope de cuadros por frame si la interfaz se queda atrás
+    static const int MAX_CUADROS_POR_FRAME = 5;
+
+    HiloSimulacion simulacion;
+    QTimer timer;        // un tic por frame de pantalla
+    QElapsedTimer reloj; // tiempo real desde el frame anterior
+    qint64 pendienteAnimNs = 0;
+    QVector<WidgetTablero*> tableros; // el índice es el de su partida en simulacion
+    QVector<Juego*> juegos;
+    PartidaRed* red = nullptr;
+    QVector<Instantanea> fotosRed;
+
+    void avanzarFrame();
+    void copiarFotosRed() {
+        for (int i = 0; i < juegos.size(); i++)
+            fotosRed[i].copiarDe(*juegos[i], red->dueloRed().instanteUltimoTick());
+    }
+
+public:
+    RelojJuego() {
+        timer.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&timer, &QTimer::timeout, &timer, [this]() { avanzarFrame(); });
+    }
+
+    // Devuelve el índice con el que el tablero pide su instantánea
+    int agregar(WidgetTablero* t, Juego* j) {
+        tableros.append(t);
+        juegos.append(j);
+        fotosRed.resize(juegos.size());
+        return simulacion.agregar(j);
+    }
+    // Con el reloj parado; nullptr vuelve al hilo de simulación
+    void usarRed(PartidaRed* r) { red = r; }
+    bool enRed() const { return red != nullptr; }
+    // Los juegos ya deben estar iniciados; hasta parar() son del hilo
+    void iniciar(QScreen* pantalla);
+    void parar() {
+        timer.stop();
+        simulacion.parar();
+    }
+
+    // En red solo manda el tablero del jugador local
+    bool enviar(int i, const Orden& o) {
+        if (red) return juegos[i] == red->juegoLocal() && red->ordenLocal(o);
+        return simulacion.enviar(i, o);
+    }
+    // Con el reloj parado, como HiloSimulacion::grabar/reproducir
+    void grabar(int i, Repeticion* r) { simulacion.grabar(i, r); }
+    void reproducir(int i, const Repeticion* r) { simulacion.reproducir(i, r); }
+    const Instantanea& instantanea(int i) const { return red ? fotosRed[i] : simulacion.instantanea(i); }
+
+    // Fracción del paso de lógica en curso que ya ha pasado desde 'instanteNs'
+    double alfa(int64_t instanteNs) const {
+        int64_t nsPaso = red ? red->dueloRed().nsPorPaso() : simulacion.nsPorPaso();
+        double a = static_cast<double>(relojMonotonoNs() - instanteNs) / nsPaso;
+        return std::min(std::max(a, 0.0), 1.0);
+    }
+};
+
+// Dibuja la última instantánea de su juego. Entre dos pasos de lógica cada
+// entidad se dibuja interpolada entre su casilla del paso anterior y la
+// actual, así el movimiento es continuo aunque la lógica vaya a 5 Hz. El
+// ritmo lo da un RelojJuego: el propio del tablero o uno compartido.
 class WidgetTablero : public QWidget {
-    Juego* juego = nullptr;
-    QTimer* timer = nullptr;
+    Juego* juego = nullptr; // solo se toca con el reloj parado
+    std::unique_ptr<RelojJuego> relojPropio;
+    RelojJuego* relojJuego = nullptr;
+    int indice = 0; // partida en relojJuego
+    // Casilla de cada enemigo en la última instantánea y en el paso anterior
+    QVector<QPointF> casillaAhoraEnemigo, casillaAntesEnemigo;
+    int tickVisto = 0;
+    uint32_t generacionVista = 0;
+    // El jugador se mueve con las teclas entre pasos: lleva su propio reloj
+    QPointF casillaAhoraJugador, casillaAntesJugador;
+    QElapsedTimer relojJugador;
     int celdaPx = 32;
-    AnimacionJugador sprites;
-    bool spritesCargados = false;
-    AnimacionEnemigo spritesEnemigo;
-    bool spritesEnemigosCargados = false;
-    AnimacionFruta spriteFruta;
-    bool spritesFrutasCargados = false;
-    AnimacionBloques spriteBloques;
-    bool spritesBloquesCargados = false;
+    // El atlas es común a todos los tableros; estos son alias de sus partes
+    std::shared_ptr<AtlasSprites> atlas = AtlasSprites::compartido();
+    const AnimacionJugador& sprites = atlas->jugador;
+    bool spritesCargados = atlas->jugadorCargado;
+    const AnimacionEnemigo& spritesEnemigo = atlas->enemigo;
+    bool spritesEnemigosCargados = atlas->enemigoCargado;
+    const AnimacionFruta& spriteFruta = atlas->fruta;
+    bool spritesFrutasCargados = atlas->frutaCargada;
+    bool spritesBloquesCargados = atlas->bloquesCargados;
+    CapaTablero capa;
+    CacheSprites escalados;
     AnimacionJugador::Tipo estadoAnim = AnimacionJugador::Idle;
     int frameAnim = 0;
     Direccion ultimaDir = Abajo;
     int tickAnim = 0;
     bool animacionFinTerminada = false;
+    // La partida se graba mientras corre y se guarda al parar; si
+    // reproduciendo, la repetición sustituye al teclado
+    Repeticion repeticion;
+    bool reproduciendo = false;
+
+    const Instantanea& foto() const { return relojJuego->instantanea(indice); }
+
+    void leerCasillas(const Instantanea& f) {
+        casillaAhoraEnemigo.resize(f.numEnemigos);
+        for (int i = 0; i < f.numEnemigos; i++) casillaAhoraEnemigo[i] = casilla(f.enemigos[i].pos);
+    }
 
 public:
-    explicit WidgetTablero(Juego* j, QWidget* parent = nullptr) : QWidget(parent), juego(j) {
+    // Con compartido == nullptr el tablero lleva su propio reloj
+    explicit WidgetTablero(Juego* j, QWidget* parent = nullptr, RelojJuego* compartido = nullptr)
+        : QWidget(parent), juego(j), relojJuego(compartido) {
         setFocusPolicy(Qt::StrongFocus);
         setMinimumSize(400, 400);
         setStyleSheet("WidgetTablero { background-color: #2a2635; }");
         qDebug() << "[Sprites] Directorio exe:" << QCoreApplication::applicationDirPath();
-        spritesCargados = sprites.cargar(rutaSprites());
-        spritesEnemigosCargados = spritesEnemigo.cargar(rutaSprites());
-        spritesFrutasCargados = spriteFruta.cargar(rutaSprites());
-        spritesBloquesCargados = spriteBloques.cargar(rutaSprites());
         if (!spritesCargados) qDebug() << "[Sprites] Usando fallback (circulos)";
-        timer = new QTimer(this);
-        connect(timer, &QTimer::timeout, this, [this]() {
-            if (!juego) return;
-            if (juego->estado == Jugando) {
-                juego->actualizar();
-                if (juego->jugador.vivo == false)
-                    estadoAnim = AnimacionJugador::Rip;
-            }
-            avanceAnimacion();
-            update();
-        });
+        if (!relojJuego) {
+            relojPropio = std::make_unique<RelojJuego>();
+            relojJuego = relojPropio.get();
+        }
+        indice = relojJuego->agregar(this, juego);
+    }
+
+    static QPointF casilla(const Posicion& pos) { return QPointF(pos.celdaX(), pos.celdaY()); }
+
+    // Todas las entidades se dibujan ya en su casilla actual
+    void reiniciarInterpolacion() {
+        const Instantanea& f = foto();
+        leerCasillas(f);
+        casillaAntesEnemigo = casillaAhoraEnemigo;
+        casillaAhoraJugador = casillaAntesJugador = casilla(f.jugador.pos);
+        relojJugador.invalidate();
+        tickVisto = f.tick;
+        generacionVista = f.mapa.generacion();
+    }
+
+    // Casilla (con decimales) en la que se dibuja ahora el jugador: un paso
+    // del jugador dura lo que tarda en recorrer una casilla a su velocidad
+    QPointF jugadorDibujado() const {
+        if (!relojJugador.isValid()) return casillaAhoraJugador;
+        double t = relojJugador.nsecsElapsed() * 1e-9 * foto().jugador.velocidad;
+        if (t >= 1) return casillaAhoraJugador;
+        return casillaAntesJugador + (casillaAhoraJugador - casillaAntesJugador) * t;
+    }
+
+    QPointF enemigoDibujado(int i, double alfa) const {
+        if (i >= casillaAhoraEnemigo.size()) return casilla(foto().enemigos[i].pos);
+        if (i >= casillaAntesEnemigo.size()) return casillaAhoraEnemigo[i];
+        return casillaAntesEnemigo[i] + (casillaAhoraEnemigo[i] - casillaAntesEnemigo[i]) * alfa;
+    }
+
+    // El reloj acaba de recoger una instantánea nueva (por un paso de lógica
+    // o por una orden del jugador)
+    void nuevaInstantanea() {
+        const Instantanea& f = foto();
+        if (f.mapa.generacion() != generacionVista) {
+            reiniciarInterpolacion();
+            return;
+        }
+        if (f.tick != tickVisto) {
+            casillaAntesEnemigo = casillaAhoraEnemigo;
+            leerCasillas(f);
+            tickVisto = f.tick;
+        }
+        QPointF cj = casilla(f.jugador.pos);
+        if (cj != casillaAhoraJugador) {
+            casillaAntesJugador = jugadorDibujado();
+            casillaAhoraJugador = cj;
+            relojJugador.start();
+        }
+        if (f.jugador.vivo == false)
+            estadoAnim = AnimacionJugador::Rip;
     }
 
     void avanceAnimacion() {
         tickAnim++;
-        if (!juego) return;
+        const Instantanea& f = foto();
         if (!spritesCargados) {
-            if (juego->jugador.dir != Ninguna) ultimaDir = juego->jugador.dir;
-            if ((juego->estado == Ganaste || juego->estado == Perdiste) && tickAnim > 12) animacionFinTerminada = true;
+            if (f.jugador.dir != Ninguna) ultimaDir = f.jugador.dir;
+            if ((f.estado == Ganaste || f.estado == Perdiste) && tickAnim > 12) animacionFinTerminada = true;
             return;
         }
-        if (juego->estado == Ganaste) {
+        if (f.estado == Ganaste) {
             if (estadoAnim != AnimacionJugador::Ganar) { estadoAnim = AnimacionJugador::Ganar; frameAnim = 0; animacionFinTerminada = false; }
             int mx = sprites.maxFrame(AnimacionJugador::Ganar, Abajo);
             if (frameAnim < mx - 1) frameAnim++; else animacionFinTerminada = true;
             return;
         }
-        if (juego->estado == Perdiste) {
+        if (f.estado == Perdiste) {
             if (estadoAnim != AnimacionJugador::Rip) { estadoAnim = AnimacionJugador::Rip; frameAnim = 0; animacionFinTerminada = false; }
             int mx = sprites.maxFrame(AnimacionJugador::Rip, Abajo);
             if (frameAnim < mx - 1) frameAnim++; else animacionFinTerminada = true;
@@ -936,8 +910,8 @@ public:
             else { estadoAnim = AnimacionJugador::Idle; frameAnim = 0; }
             return;
         }
-        if (juego->jugador.dir != Ninguna) {
-            ultimaDir = juego->jugador.dir;
+        if (f.jugador.dir != Ninguna) {
+            ultimaDir = f.jugador.dir;
             estadoAnim = AnimacionJugador::Caminar;
         } else {
             estadoAnim = AnimacionJugador::Idle;
@@ -948,21 +922,83 @@ public:
         if (tickAnim % 2 == 0) frameAnim = (frameAnim + 1) % mx;
     }
 
-    void iniciarLoop() { timer->start(200); }
-    void pararLoop() { timer->stop(); }
+    void guardarRepeticion() {
+        QDir().mkpath(rutaRepeticiones());
+        QString nombre = QString("nivel%1-%2.icr")
+            .arg(repeticion.nivel)
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+        QString ruta = QDir(rutaRepeticiones()).absoluteFilePath(nombre);
+        std::vector<uint8_t> bytes = repeticion.codificar();
+        QFile f(ruta);
+        if (!f.open(QIODevice::WriteOnly) ||
+            f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<qint64>(bytes.size())) !=
+                static_cast<qint64>(bytes.size()))
+            qWarning() << "[Repeticion] No se pudo guardar" << ruta;
+    }
+
+    // Con reloj compartido arrancan y paran todos sus tableros a la vez
+    void iniciarLoop() {
+        if (reproduciendo) relojJuego->reproducir(indice, &repeticion);
+        else relojJuego->grabar(indice, &repeticion);
+        relojJuego->iniciar(screen());
+    }
+    void pararLoop() {
+        relojJuego->parar();
+        if (!reproduciendo && repeticion.ticksFinal > 0) guardarRepeticion();
+        relojJuego->grabar(indice, nullptr);
+        relojJuego->reproducir(indice, nullptr);
+        repeticion = Repeticion();
+        reproduciendo = false;
+    }
+
+    // F5 guarda la partida en curso y F9 vuelve a la guardada, parando el hilo
+    // solo lo que dura la copia. Al volver atrás la grabación ya no describe la
+    // partida, así que se descarta.
+    void guardarPartida() {
+        relojJuego->parar();
+        std::vector<uint8_t> bytes = Guardado::codificar(*juego);
+        relojJuego->iniciar(screen());
+        QFile f(rutaGuardado());
+        if (!f.open(QIODevice::WriteOnly) ||
+            f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<qint64>(bytes.size())) !=
+                static_cast<qint64>(bytes.size()))
+            qWarning() << "[Guardado] No se pudo guardar" << rutaGuardado();
+    }
+    void cargarPartida() {
+        QFile f(rutaGuardado());
+        QByteArray bytes;
+        if (f.open(QIODevice::ReadOnly)) bytes = f.readAll();
+        relojJuego->parar();
+        if (Guardado::decodificar(*juego, reinterpret_cast<const uint8_t*>(bytes.constData()),
+                                  static_cast<size_t>(bytes.size()))) {
+            relojJuego->grabar(indice, nullptr);
+            repeticion = Repeticion();
+            capa.invalidar();
+            estadoAnim = AnimacionJugador::Idle;
+            frameAnim = 0;
+            animacionFinTerminada = false;
+        } else {
+            qWarning() << "[Guardado] No hay partida válida en" << rutaGuardado();
+        }
+        relojJuego->iniciar(screen());
+    }
+
+    // Juega r en tiempo real en este tablero; false si no es del tablero clásico
+    bool reproducir(const Repeticion& r) {
+        pararLoop();
+        if (!prepararRepeticion(*juego, r)) return false;
+        repeticion = r;
+        reproduciendo = true;
+        iniciarLoop();
+        return true;
+    }
 
     void dibujarSpriteJugador(QPainter& p, int jx, int jy, int lado) {
         if (spritesCargados) {
             AnimacionJugador::Tipo t = estadoAnim;
-            if (juego->estado == Ganaste) t = AnimacionJugador::Ganar;
-            else if (juego->estado == Perdiste) t = AnimacionJugador::Rip;
-            QPixmap pm = sprites.frame(t, ultimaDir, frameAnim);
-            int sw = pm.width(), sh = pm.height();
-            int drawW = std::min(lado, sw), drawH = std::min(lado, sh);
-            if (drawW > 0 && drawH > 0) {
-                QRect dest(jx - drawW/2, jy - drawH/2, drawW, drawH);
-                p.drawPixmap(dest, pm, pm.rect());
-            } else {
+            if (foto().estado == Ganaste) t = AnimacionJugador::Ganar;
+            else if (foto().estado == Perdiste) t = AnimacionJugador::Rip;
+            if (!escalados.dibujar(p, jx, jy, sprites.frame(t, ultimaDir, frameAnim), lado)) {
                 int rj = lado/3;
                 p.setPen(Qt::NoPen);
                 p.setBrush(QColor(90, 150, 210));
@@ -981,81 +1017,38 @@ public:
     void paintEvent(QPaintEvent*) override {
         QPainter p(this);
         p.setRenderHint(QPainter::Antialiasing);
-        p.setRenderHint(QPainter::SmoothPixmapTransform);
         if (!juego) return;
-        const Mapa& m = juego->mapa;
+        const Instantanea& f = foto();
+        const Mapa& m = f.mapa;
         int w = width(), h = height();
         int lado = std::min(w, h) / TAM_TABLERO;
         celdaPx = lado;
         int offsetX = (w - TAM_TABLERO * lado) / 2;
         int offsetY = (h - TAM_TABLERO * lado) / 2;
-
-        for (int r = 0; r < TAM_TABLERO; r++) {
-            for (int c = 0; c < TAM_TABLERO; c++) {
-                int x = offsetX + c * lado, y = offsetY + r * lado;
-                QRect rect(x + 2, y + 2, lado - 3, lado - 3);
-                TipoCelda t = m.obtenerCelda(r, c);
-                if (spritesBloquesCargados && !spriteBloques.bordes.isNull()) {
-                    if (t == Muro) {
-                        p.drawPixmap(rect, spriteBloques.bordes, spriteBloques.bordes.rect());
-                    } else if (t == Hielo) {
-                        p.drawPixmap(rect, spriteBloques.hielo, spriteBloques.hielo.rect());
-                    } else {
-                        QPixmap& nievePm = ((r + c) % 2 == 0) ? spriteBloques.nieve : spriteBloques.nieve2;
-                        p.drawPixmap(rect, nievePm, nievePm.rect());
-                    }
-                } else {
-                    if (t == Muro) {
-                        p.fillRect(rect, QColor(72, 65, 85));
-                        p.setPen(QColor(50, 45, 60));
-                        for (int b = 0; b < 2; b++) p.drawRect(rect.adjusted(b, b, -b, -b));
-                        p.setPen(QColor(95, 88, 110));
-                        p.drawLine(rect.left(), rect.top(), rect.right(), rect.top());
-                        p.drawLine(rect.left(), rect.top(), rect.left(), rect.bottom());
-                    } else if (t == Hielo) {
-                        QLinearGradient grad(rect.topLeft(), rect.bottomRight());
-                        grad.setColorAt(0, QColor(200, 235, 255));
-                        grad.setColorAt(1, QColor(150, 205, 245));
-                        p.fillRect(rect, grad);
-                        p.setPen(QColor(100, 160, 210));
-                        p.drawRect(rect);
-                    } else {
-                        QLinearGradient grad(rect.topLeft(), rect.bottomRight());
-                        grad.setColorAt(0, QColor(252, 250, 245));
-                        grad.setColorAt(1, QColor(238, 232, 220));
-                        p.fillRect(rect, grad);
-                        p.setPen(QColor(210, 202, 190));
-                        p.drawRect(rect);
-                    }
-                }
-            }
-        }
-
-        for (int i = 0; i < juego->numFrutas; i++) {
-            if (juego->frutas[i].recogida) continue;
-            int fc = juego->frutas[i].pos.celdaX(), fr = juego->frutas[i].pos.celdaY();
+        double alfa = relojJuego->alfa(f.instanteNs);
+        auto pixel = [&](qreal casilla, int offset) { return offset + qRound(casilla * lado) + lado/2; };
+
+        // Muros, nieve y hielo salen de la capa ya pintada; encima, lo que se mueve
+        // (nullptr hasta que la tanda de bloques esté decodificada)
+        const AtlasSprites* bloques = spritesBloquesCargados && atlas->valido(atlas->bloques.bordes) ? atlas.get() : nullptr;
+        p.drawPixmap(offsetX, offsetY, capa.actualizar(m, lado, devicePixelRatioF(), bloques));
+        // Los sprites ya vienen escalados a este lado: se copian sin suavizado
+        escalados.preparar(atlas.get(), lado, devicePixelRatioF());
+
+        for (int i = 0; i < f.numFrutas; i++) {
+            int fc = f.frutas[i].pos.celdaX(), fr = f.frutas[i].pos.celdaY();
             int fx = offsetX + fc * lado + lado/2, fy = offsetY + fr * lado + lado/2;
-            bool congelada = juego->frutas[i].congelada;
-            if (spritesFrutasCargados && !spriteFruta.sprite.isNull()) {
-                QPixmap& pm = spriteFruta.sprite;
-                int drawW = std::min(lado/2, pm.width()), drawH = std::min(lado/2, pm.height());
-                if (drawW > 0 && drawH > 0) {
-                    QRect dest(fx - drawW/2, fy - drawH/2, drawW, drawH);
-                    p.drawPixmap(dest, pm, pm.rect());
-                    // Overlay azul para fruta congelada (se distingue de la normal)
-                    if (congelada) {
-                        p.setCompositionMode(QPainter::CompositionMode_SourceOver);
-                        p.fillRect(dest, QColor(150, 210, 255, 140));
-                    }
-                } else {
+            bool congelada = f.frutas[i].congelada;
+            if (spritesFrutasCargados && atlas->valido(spriteFruta.sprite)) {
+                if (!escalados.dibujar(p, fx, fy, spriteFruta.sprite, lado/2, congelada)) {
                     p.setPen(Qt::NoPen);
-                    p.setBrush(congelada ? QColor(150, 200, 255) : (juego->frutas[i].tipoFruta == Uva ? QColor(100, 50, 120) : QColor(220, 180, 50)));
+                    p.setBrush(congelada ? QColor(150, 200, 255) : (f.frutas[i].tipoFruta == Uva ? QColor(100, 50, 120) : QColor(220, 180, 50)));
                     p.drawEllipse(QPoint(fx, fy), lado/4, lado/4);
                 }
             } else {
                 if (congelada)
                     p.setBrush(QColor(150, 200, 255));
-                else if (juego->frutas[i].tipoFruta == Uva)
+                else if (f.frutas[i].tipoFruta == Uva)
                     p.setBrush(QColor(100, 50, 120));
                 else
                     p.setBrush(QColor(220, 180, 50));
@@ -1064,34 +1057,29 @@ public:
             }
         }
 
-        int jx = offsetX + juego->jugador.pos.celdaX() * lado + lado/2;
-        int jy = offsetY + juego->jugador.pos.celdaY() * lado + lado/2;
-        if ((juego->jugador.vivo || juego->estado == Perdiste) && juego->estado == Jugando) {
+        QPointF pj = jugadorDibujado();
+        int jx = pixel(pj.x(), offsetX), jy = pixel(pj.y(), offsetY);
+        if ((f.jugador.vivo || f.estado == Perdiste) && f.estado == Jugando) {
             dibujarSpriteJugador(p, jx, jy, lado);
         }
 
-        for (int i = 0; i < juego->numEnemigos; i++) {
-            if (!juego->enemigos[i].vivo) continue;
-            int ex = offsetX + juego->enemigos[i].pos.celdaX() * lado + lado/2;
-            int ey = offsetY + juego->enemigos[i].pos.celdaY() * lado + lado/2;
-            Direccion dirE = juego->enemigos[i].dir;
+        for (int i = 0; i < f.numEnemigos; i++) {
+            if (!f.enemigos[i].vivo) continue;
+            QPointF pe = enemigoDibujado(i, alfa);
+            int ex = pixel(pe.x(), offsetX), ey = pixel(pe.y(), offsetY);
+            Direccion dirE = f.enemigos[i].dir;
             bool moviendo = (dirE != Ninguna);
             int frameE = (frameAnim + i * 2) % 8; // desfasar por enemigo para variedad
             if (spritesEnemigosCargados) {
-                QPixmap pm = spritesEnemigo.frame(dirE, frameE, moviendo);
-                int drawW = std::min(lado, pm.width()), drawH = std::min(lado, pm.height());
-                if (drawW > 0 && drawH > 0) {
-                    QRect dest(ex - drawW/2, ey - drawH/2, drawW, drawH);
-                    p.drawPixmap(dest, pm, pm.rect());
-                } else {
+                if (!escalados.dibujar(p, ex, ey, spritesEnemigo.frame(dirE, frameE, moviendo), lado)) {
                     int re = lado/3 - 2;
                     p.setPen(Qt::NoPen);
-                    p.setBrush(juego->enemigos[i].tipo == Especial ? QColor(220, 90, 90) : QColor(200, 70, 70));
+                    p.setBrush(f.enemigos[i].tipo == Especial ? QColor(220, 90, 90) : QColor(200, 70, 70));
                     p.drawEllipse(QPoint(ex, ey), re, re);
                 }
             } else {
                 int re = lado/3 - 2;
-                bool esp = juego->enemigos[i].tipo == Especial;
+                bool esp = f.enemigos[i].tipo == Especial;
                 p.setPen(Qt::NoPen);
                 p.setBrush(esp ? QColor(120, 40, 40) : QColor(100, 35, 35));
                 p.drawEllipse(QPoint(ex + 1, ey + 1), re, re);
@@ -1100,14 +1088,14 @@ public:
             }
         }
 
-        if (juego->estado == Ganaste || juego->estado == Perdiste) {
+        if (f.estado == Ganaste || f.estado == Perdiste) {
             dibujarSpriteJugador(p, jx, jy, lado);
         }
 
-        if ((juego->estado == Ganaste || juego->estado == Perdiste) && animacionFinTerminada) {
+        if ((f.estado == Ganaste || f.estado == Perdiste) && animacionFinTerminada) {
             p.fillRect(0, 0, width(), height(), QColor(0, 0, 0, 180));
-            QFont f = font(); f.setPointSize(20); f.setBold(true); p.setFont(f);
-            if (juego->estado == Ganaste) {
+            QFont fuente = font(); fuente.setPointSize(20); fuente.setBold(true); p.setFont(fuente);
+            if (f.estado == Ganaste) {
                 p.setPen(QColor(200, 255, 200));
                 p.drawText(rect(), Qt::AlignCenter, "¡Ganaste!");
             } else {
@@ -1117,30 +1105,70 @@ public:
         }
     }
 
+    // Las teclas no tocan el juego: van como órdenes al hilo de simulación y
+    // su efecto llega en la siguiente instantánea
     void keyPressEvent(QKeyEvent* e) override {
-        if (!juego || juego->estado != Jugando) return;
+        if (!juego || reproduciendo) return;
+        // Guardar y cargar solo en el modo niveles: en 1vs1 el reloj es de los dos
+        if (relojPropio && e->key() == Qt::Key_F5) { if (foto().estado == Jugando) guardarPartida(); return; }
+        if (relojPropio && e->key() == Qt::Key_F9) { cargarPartida(); return; }
+        if (foto().estado != Jugando) return;
         switch (e->key()) {
-            case Qt::Key_Up:    juego->moverJugador(Arriba); break;
-            case Qt::Key_Down:  juego->moverJugador(Abajo); break;
-            case Qt::Key_Left:  juego->moverJugador(Izquierda); break;
-            case Qt::Key_Right: juego->moverJugador(Derecha); break;
+            case Qt::Key_Up:    relojJuego->enviar(indice, {OrdenMover, Arriba}); break;
+            case Qt::Key_Down:  relojJuego->enviar(indice, {OrdenMover, Abajo}); break;
+            case Qt::Key_Left:  relojJuego->enviar(indice, {OrdenMover, Izquierda}); break;
+            case Qt::Key_Right: relojJuego->enviar(indice, {OrdenMover, Derecha}); break;
             case Qt::Key_Space:
-                juego->congelar();
+                relojJuego->enviar(indice, {OrdenCongelar, Ninguna});
                 estadoAnim = AnimacionJugador::Congelar;
                 frameAnim = 0;
-                ultimaDir = (juego->jugador.dir != Ninguna) ? juego->jugador.dir : ultimaDir;
+                ultimaDir = (foto().jugador.dir != Ninguna) ? foto().jugador.dir : ultimaDir;
                 break;
             case Qt::Key_Shift:
-                juego->descongelar();
+                relojJuego->enviar(indice, {OrdenDescongelar, Ninguna});
                 estadoAnim = AnimacionJugador::RomperHielo;
                 frameAnim = 0;
                 break;
             default: break;
         }
-        update();
     }
 };
 
+inline void RelojJuego::avanzarFrame() {
+    qint64 ns = reloj.nsecsElapsed();
+    reloj.start();
+    if (red) {
+        // Tras una vuelta atrás cambia la partida sin cambiar el tick: se copian siempre
+        red->avanzar(relojMonotonoNs());
+        copiarFotosRed();
+        for (WidgetTablero* t : tableros) t->nuevaInstantanea();
+    } else {
+        for (int i = 0; i < tableros.size(); i++)
+            if (simulacion.recoger(i)) tableros[i]->nuevaInstantanea();
+    }
+    const qint64 nsPorCuadro = 1000000000LL / CUADROS_ANIM_POR_SEGUNDO;
+    pendienteAnimNs = std::min(pendienteAnimNs + ns, nsPorCuadro * MAX_CUADROS_POR_FRAME);
+    while (pendienteAnimNs >= nsPorCuadro) {
+        pendienteAnimNs -= nsPorCuadro;
+        for (WidgetTablero* t : tableros) t->avanceAnimacion();
+    }
+    for (WidgetTablero* t : tableros) t->update();
+}
+
+inline void RelojJuego::iniciar(QScreen* pantalla) {
+    if (red) {
+        copiarFotosRed();
+    } else {
+        simulacion.iniciar();
+        for (int i = 0; i < tableros.size(); i++) simulacion.recoger(i);
+    }
+    qreal hz = pantalla ? pantalla->refreshRate() : 60;
+    timer.start(std::max(1, static_cast<int>(1000 / std::max<qreal>(hz, 1))));
+    reloj.start();
+    pendienteAnimNs = 0;
+    for (WidgetTablero* t : tableros) t->reiniciarInterpolacion();
+}
+
 class PantallaUnoVsUno;
 
 class PantallaModo : public QWidget {
@@ -1256,7 +1284,18 @@ public:
             btn->setFont(QFont("Sans", 18));
             int nivel = n;
             connect(btn, &QPushButton::clicked, this, [this, nivel]() {
-                juego->iniciarNivel(nivel);
+                tablero->pararLoop(); // el juego solo se toca con su hilo parado
+                // Una repetición vista antes puede haberlos cambiado
+                juego->esBot = false;
+                juego->ticksPorSegundo = TICKS_POR_SEGUNDO;
+                const PaqueteNiveles& paquete = paqueteNiveles();
+                size_t cuantos = paquete.cuantos(nivel);
+                bool empaquetado = false;
+                if (cuantos > 0) {
+                    size_t k = static_cast<size_t>(QRandomGenerator::global()->bounded(static_cast<quint64>(cuantos)));
+                    empaquetado = iniciarNivelEmpaquetado(*juego, paquete.nivel(nivel, k));
+                }
+                if (!empaquetado) juego->iniciarNivel(nivel, QRandomGenerator::global()->generate64());
                 tablero->iniciarLoop();
                 // 0: Modo | 1: Menú niveles | 2: Juego | 3: 1vs1
                 if (stack->count() > 2) stack->setCurrentIndex(2);
@@ -1272,9 +1311,36 @@ public:
 class PantallaUnoVsUno : public QWidget {
     QStackedWidget* stack = nullptr;
     Juego juego1;
-    Juego juegoBot;
+    Juego juegoBot; // en red, la partida del otro jugador
+    std::unique_ptr<PartidaRed> red; // antes que el reloj: el reloj la usa hasta destruirse
+    RelojJuego reloj; // uno para los dos tableros
     WidgetTablero* tablero1 = nullptr;
     WidgetTablero* tableroBot = nullptr;
+    QLabel* etiqueta2 = nullptr;
+    QLabel* estadoRed = nullptr;
+    QPushButton* reiniciar = nullptr;
+    QTimer timerEstado;
+
+    void actualizarEstadoRed() {
+        if (!red) return;
+        const DueloRed& d = red->dueloRed();
+        const SesionRollback& s = d.sesionRollback();
+        if (!d.enMarcha()) {
+            estadoRed->setText(red->esAnfitrion() ? "Esperando a que se conecte el otro jugador..."
+                                                  : "Conectando con el anfitrión...");
+            return;
+        }
+        if (s.desincronizado()) {
+            estadoRed->setText("¡Las partidas se han desincronizado!");
+            return;
+        }
+        const EstadisticasRollback& e = s.estadisticas();
+        estadoRed->setText(QString("En red | tick %1 | vueltas atrás %2 (máx %3 ticks) | esperas %4")
+                               .arg(s.tick())
+                               .arg(static_cast<int>(e.vueltas))
+                               .arg(e.maxVuelta)
+                               .arg(static_cast<int>(e.esperas)));
+    }
 
 public:
     explicit PantallaUnoVsUno(QStackedWidget* s, QWidget* parent = nullptr)
@@ -1300,15 +1366,15 @@ public:
         QLabel* l1 = new QLabel("Mapa Jugador 1");
         l1->setAlignment(Qt::AlignCenter);
         col1->addWidget(l1);
-        tablero1 = new WidgetTablero(&juego1, this);
+        tablero1 = new WidgetTablero(&juego1, this, &reloj);
         tablero1->setMinimumSize(360, 360);
         col1->addWidget(tablero1, 1);
 
         QVBoxLayout* col2 = new QVBoxLayout();
-        QLabel* l2 = new QLabel("Mapa Jugador 2 (Bot)");
-        l2->setAlignment(Qt::AlignCenter);
-        col2->addWidget(l2);
-        tableroBot = new WidgetTablero(&juegoBot, this);
+        etiqueta2 = new QLabel("Mapa Jugador 2 (Bot)");
+        etiqueta2->setAlignment(Qt::AlignCenter);
+        col2->addWidget(etiqueta2);
+        tableroBot = new WidgetTablero(&juegoBot, this, &reloj);
         tableroBot->setMinimumSize(360, 360);
         col2->addWidget(tableroBot, 1);
 
@@ -1316,28 +1382,55 @@ public:
         filas->addLayout(col2, 1);
         mainL->addLayout(filas, 1);
 
-        QPushButton* reiniciar = new QPushButton("Reiniciar duelo (nivel 5)");
+        reiniciar = new QPushButton("Reiniciar duelo (nivel 5)");
         connect(reiniciar, &QPushButton::clicked, this, [this]() {
             iniciarPartida();
         });
         mainL->addWidget(reiniciar, 0, Qt::AlignCenter);
+        estadoRed = new QLabel("");
+        estadoRed->setAlignment(Qt::AlignCenter);
+        mainL->addWidget(estadoRed);
+        connect(&timerEstado, &QTimer::timeout, this, [this]() { actualizarEstadoRed(); });
 
         iniciarPartida();
     }
 
+    // Duelo contra otro proceso: juego1 es el de este jugador y juegoBot el
+    // del otro. El nivel y la semilla los pone el anfitrión y la partida
+    // empieza cuando los dos se han saludado; no se puede reiniciar.
+    bool iniciarRed(bool anfitrion, const QHostAddress& host, quint16 puerto, int latenciaMs) {
+        reloj.parar();
+        reloj.usarRed(nullptr);
+        DueloRed::Partida p;
+        p.semilla = QRandomGenerator::global()->generate64();
+        red = std::make_unique<PartidaRed>(&juego1, &juegoBot, anfitrion, host, puerto, latenciaMs, p);
+        if (!red->abrir()) {
+            red.reset();
+            iniciarPartida();
+            return false;
+        }
+        reloj.usarRed(red.get());
+        etiqueta2->setText("Mapa Jugador 2 (en red)");
+        reiniciar->hide();
+        actualizarEstadoRed();
+        timerEstado.start(250);
+        reloj.iniciar(screen());
+        if (tablero1) tablero1->setFocus();
+        return true;
+    }
+
     void iniciarPartida() {
+        reloj.parar(); // los juegos solo se tocan con su hilo parado
         juego1.esBot = false;
         juegoBot.esBot = true;
-        juego1.iniciarNivel(5);
-        juegoBot.iniciarNivel(5);
-        if (tablero1) tablero1->iniciarLoop();
-        if (tableroBot) tableroBot->iniciarLoop();
+        juego1.iniciarNivel(5, QRandomGenerator::global()->generate64());
+        juegoBot.iniciarNivel(5, QRandomGenerator::global()->generate64());
+        reloj.iniciar(screen());
         if (tablero1) tablero1->setFocus();
     }
 
     void detener() {
-        if (tablero1) tablero1->pararLoop();
-        if (tableroBot) tableroBot->pararLoop();
+        reloj.parar();
     }
 };
 
@@ -1348,6 +1441,7 @@ class VentanaPrincipal : public QMainWindow {
     PantallaNiveles* pantallaNiveles = nullptr;
     PantallaUnoVsUno* pantalla1v1 = nullptr;
     PantallaModo* pantallaModo = nullptr;
+    bool primerFramePintado = false;
 
 public:
     VentanaPrincipal() : QMainWindow(nullptr) {
@@ -1380,16 +1474,70 @@ public:
         });
         topL->addWidget(volver);
         topL->addStretch();
-        QLabel* instrucciones = new QLabel("Flechas: mover | Espacio: congelar | Shift: descongelar");
+        QLabel* instrucciones = new QLabel("Flechas: mover | Espacio: congelar | Shift: descongelar | F5/F9: guardar/cargar");
         topL->addWidget(instrucciones);
         centralL->addLayout(topL);
         centralL->addWidget(stack, 1);
     }
+
+    // Duelo 1 vs 1 en red: como anfitrión en 'puerto' o como invitado de host:puerto
+    bool jugarEnRed(bool anfitrion, const QString& host, quint16 puerto, int latenciaMs) {
+        stack->setCurrentWidget(pantalla1v1);
+        return pantalla1v1->iniciarRed(anfitrion, QHostAddress(host), puerto, latenciaMs);
+    }
+
+    // Abre una partida grabada y la juega en el tablero a velocidad real
+    bool verRepeticion(const QString& ruta) {
+        QFile f(ruta);
+        Repeticion r;
+        QByteArray bytes;
+        if (f.open(QIODevice::ReadOnly)) bytes = f.readAll();
+        if (!Repeticion::decodificar(reinterpret_cast<const uint8_t*>(bytes.constData()),
+                                     static_cast<size_t>(bytes.size()), r) ||
+            !tablero->reproducir(r)) {
+            qWarning() << "[Repeticion] No se pudo reproducir" << ruta;
+            return false;
+        }
+        stack->setCurrentWidget(tablero);
+        tablero->setFocus();
+        return true;
+    }
+
+    // El tablero (hijo) se destruye después que 'juego': su hilo se para antes
+    ~VentanaPrincipal() override { tablero->pararLoop(); }
+
+protected:
+    void paintEvent(QPaintEvent* e) override {
+        QMainWindow::paintEvent(e);
+        if (primerFramePintado) return;
+        primerFramePintado = true;
+        qDebug() << "[Arranque] Primer frame a los" << relojArranque().elapsed() << "ms de main()";
+    }
 };
 
 int main(int argc, char* argv[]) {
+    relojArranque().start();
     QApplication app(argc, argv);
     VentanaPrincipal v;
+    // PROYECTO --repeticion partida.icr: abre directamente la repetición
+    QStringList args = QCoreApplication::arguments();
+    int i = args.indexOf("--repeticion");
+    if (i >= 0 && i + 1 < args.size()) v.verRepeticion(args[i + 1]);
+    // PROYECTO --anfitrion 7777 | --invitado 127.0.0.1:7777, y opcionalmente
+    // --latencia-simulada MS de retraso en cada datagrama que sale
+    int latencia = 0;
+    i = args.indexOf("--latencia-simulada");
+    if (i >= 0 && i + 1 < args.size()) latencia = std::max(0, args[i + 1].toInt());
+    i = args.indexOf("--anfitrion");
+    if (i >= 0 && i + 1 < args.size()) v.jugarEnRed(true, QString(), static_cast<quint16>(args[i + 1].toUInt()), latencia);
+    i = args.indexOf("--invitado");
+    if (i >= 0 && i + 1 < args.size()) {
+        QString destino = args[i + 1];
+        int dosPuntos = destino.lastIndexOf(':');
+        if (dosPuntos > 0)
+            v.jugarEnRed(false, destino.left(dosPuntos), static_cast<quint16>(destino.mid(dosPuntos + 1).toUInt()),
+                         latencia);
+    }
     v.show();
     return app.exec();
 }
\ No newline at end of file
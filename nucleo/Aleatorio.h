@@ -0,0 +1,59 @@
+#ifndef NUCLEO_ALEATORIO_H
+#define NUCLEO_ALEATORIO_H
+
+#include <cstdint>
+
+// Generador xoshiro256** propio de cada Juego. Reemplaza a QRandomGenerator::global():
+// no comparte estado entre partidas (ni entre hilos) y, con la misma semilla y
+// las mismas entradas, reproduce exactamente la misma secuencia de ticks.
+class Aleatorio {
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    Aleatorio() { sembrar(0); }
+    explicit Aleatorio(uint64_t semilla) { sembrar(semilla); }
+
+    // Expande la semilla con splitmix64 para no arrancar nunca del estado todo ceros
+    void sembrar(uint64_t semilla) {
+        for (auto& palabra : s) {
+            semilla += 0x9E3779B97F4A7C15ull;
+            uint64_t z = semilla;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            palabra = z ^ (z >> 31);
+        }
+    }
+
+    // Estado completo, para guardarlo aparte y seguir después la misma secuencia
+    void leerEstado(uint64_t destino[4]) const {
+        for (int i = 0; i < 4; i++) destino[i] = s[i];
+    }
+    void fijarEstado(const uint64_t origen[4]) {
+        for (int i = 0; i < 4; i++) s[i] = origen[i];
+    }
+
+    uint64_t siguiente() {
+        uint64_t res = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return res;
+    }
+
+    // Entero uniforme en [0, n) por multiplicación (Lemire), sin divisiones
+    int acotado(int n) {
+        return static_cast<int>((static_cast<uint64_t>(static_cast<uint32_t>(siguiente() >> 32)) *
+                                 static_cast<uint64_t>(n)) >> 32);
+    }
+
+    // Real uniforme en [0, 1) con 53 bits de mantisa
+    double real() { return static_cast<double>(siguiente() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+#endif // NUCLEO_ALEATORIO_H
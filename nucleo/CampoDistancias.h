@@ -0,0 +1,360 @@
+#ifndef NUCLEO_CAMPODISTANCIAS_H
+#define NUCLEO_CAMPODISTANCIAS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Config.h"
+#include "Mapa.h"
+
+// Distancia en pasos (BFS en 4 direcciones) hasta un destino, con la
+// transitabilidad de una ReglaPaso: los enemigos Normal no cruzan el hielo y
+// los Especial sí; el jugador tampoco cruza el hielo pero sí las frutas. El
+// destino es la celda del jugador (actualizar) o todas las frutas que se
+// pueden recoger (actualizarHaciaFrutas, para el bot). Quien lo consulta lee
+// su siguiente paso sin recorrer el tablero; todos los enemigos de un tipo
+// comparten campo.
+//
+// El campo se reconstruye cuando cambia el destino, y la BFS solo avanza lo
+// necesario para responder a quien pregunta (los enemigos suelen estar más
+// cerca que el rincón más lejano del tablero). Los cambios que el Mapa anota
+// (hielo creado o roto, fruta congelada, liberada o recogida) se ignoran si no
+// afectan a la regla ni a los destinos.
+//
+// Con el lado fijado al compilar, la BFS avanza por capas sobre las palabras
+// de PlanoBits (4 en el tablero clásico): cada capa es la vecindad de la
+// anterior menos lo ya visto y se guarda entera, así la distancia de una
+// casilla es la capa que la contiene. Ahí un cambio que afecta al campo lo
+// rehace entero: reparar dist[] sale unas tres veces más barato por cambio de
+// hielo (bench, CampoDistancias/hielo), pero los campos de los enemigos se
+// rehacen igualmente cada vez que el jugador cambia de casilla, y eso con
+// capas cuesta la sexta parte; con dist[] y reparación en el tablero clásico
+// el lote del simulador va 2,6 veces más lento.
+//
+// En los mapas dinámicos, cola de casillas y dist[] por casilla, y ahí los
+// cambios se reparan: se invalidan solo las distancias que dependían de una
+// casilla cerrada o de un destino perdido y se vuelven a propagar desde su
+// borde, desde las casillas abiertas y desde los destinos nuevos.
+template <class Cfg>
+class CampoDistancias {
+public:
+    static constexpr int32_t BLOQUEADA = -1;
+    static constexpr int32_t INALCANZABLE = INT32_MAX;
+
+private:
+    static constexpr bool POR_CAPAS = Cfg::TAM != DINAMICO;
+    using Plano = PlanoBits<Cfg::TAM>;
+    static constexpr int PALABRAS = Plano::PALABRAS;
+
+    Cfg cfg;
+    ReglaPaso regla = PasoNormal;
+    bool haciaFrutas = false;
+    int raiz = -1; // índice de la celda del jugador (sin uso hacia las frutas)
+    bool construido = false;
+    uint32_t generacionVista = 0;
+    uint64_t versionVista = 0;
+
+    // Tablero fijo: capas[d * PALABRAS + k] es la palabra k de la capa d. Las
+    // casillas fuera de 'visto' son INALCANZABLE o BLOQUEADA según 'libre'.
+    Plano libre, visto; // solo las palabras por filas
+    std::array<uint64_t, POR_CAPAS ? celdasTablero(Cfg::TAM) * PALABRAS : 0> capas{};
+    int32_t capa = 0; // última capa calculada
+    bool frenteVivo = false;
+
+    // Mapa dinámico: distancia por casilla y BFS en curso en cola[cabeza, finCola)
+    std::vector<int32_t> dist;
+    std::vector<int> cola;
+    int cabeza = 0, finCola = 0;
+    // Memoria de trabajo de repararCasillas(), reutilizada entre llamadas
+    std::vector<int> pendientes;
+    std::vector<std::pair<int, int32_t>> invalidas;
+    std::vector<std::pair<int32_t, int>> monticulo;
+    std::vector<int> destinosNuevos;
+
+    int tam() const { return cfg.tam(); }
+
+    bool esDestino(const MapaT<Cfg>& mapa, int fila, int col) const {
+        return haciaFrutas ? mapa.frutaAlAlcance(fila, col) : fila * tam() + col == raiz;
+    }
+
+    // Vecinos en el orden de Direccion (Arriba, Abajo, Izquierda, Derecha). Solo
+    // se llama con casillas interiores: el borde es muro.
+    template <class F>
+    void vecinos(int i, F&& f) const {
+        f(i - tam());
+        f(i + tam());
+        f(i - 1);
+        f(i + 1);
+    }
+
+    void reconstruir(const MapaT<Cfg>& mapa) {
+        if constexpr (POR_CAPAS) {
+            constexpr uint64_t MASCARA = (1ull << Cfg::TAM) - 1;
+            for (int k = 0; k < PALABRAS; k++) libre.w[k] = visto.w[k] = 0;
+            for (int f = 0; f < tam(); f++) {
+                libre.w[Plano::palabra(f)] |= (~mapa.intransitables(regla, true, f, 0) & MASCARA)
+                                              << Plano::desplazamiento(f, 0);
+                if (haciaFrutas)
+                    visto.w[Plano::palabra(f)] |= mapa.frutasAlAlcance(true, f, 0) << Plano::desplazamiento(f, 0);
+            }
+            if (!haciaFrutas) visto.poner(raiz / tam(), raiz % tam());
+            uint64_t alguno = 0;
+            for (int k = 0; k < PALABRAS; k++) alguno |= capas[k] = visto.w[k];
+            capa = 0;
+            frenteVivo = alguno != 0;
+        } else {
+            dist.resize(static_cast<size_t>(tam()) * tam());
+            cola.resize(dist.size());
+            // Todo inalcanzable salvo lo intransitable, que se marca fila a fila
+            // recorriendo los bits de la máscara (muros y poco más)
+            std::fill(dist.begin(), dist.end(), INALCANZABLE);
+            cabeza = finCola = 0;
+            for (int f = 0; f < tam(); f++) {
+                int32_t* fila = &dist[static_cast<size_t>(f) * tam()];
+                for (int k = 0; k * 64 < tam(); k++) {
+                    for (uint64_t m = mapa.intransitables(regla, true, f, k); m; m &= m - 1)
+                        fila[k * 64 + bitMenor(m)] = BLOQUEADA;
+                    if (!haciaFrutas) continue;
+                    for (uint64_t m = mapa.frutasAlAlcance(true, f, k); m; m &= m - 1) {
+                        fila[k * 64 + bitMenor(m)] = 0;
+                        cola[finCola++] = f * tam() + k * 64 + bitMenor(m);
+                    }
+                }
+            }
+            if (!haciaFrutas) {
+                dist[raiz] = 0;
+                cola[finCola++] = raiz;
+            }
+        }
+    }
+
+    // Siguiente capa de la BFS por bits; apaga frenteVivo al agotarse
+    void avanzarCapa() {
+        uint64_t nuevo[PALABRAS];
+        Plano::vecindad(&capas[capa * PALABRAS], nuevo);
+        uint64_t alguno = 0;
+        for (int k = 0; k < PALABRAS; k++) {
+            nuevo[k] &= libre.w[k] & ~visto.w[k];
+            alguno |= nuevo[k];
+        }
+        if (alguno == 0) {
+            frenteVivo = false;
+            return;
+        }
+        capa++;
+        for (int k = 0; k < PALABRAS; k++) {
+            visto.w[k] |= nuevo[k];
+            capas[capa * PALABRAS + k] = nuevo[k];
+        }
+    }
+
+    // Avanza la BFS hasta descubrir la casilla i (en BFS, una distancia
+    // asignada ya es definitiva) o hasta agotarla si i < 0
+    void expandirHasta(int i) {
+        if constexpr (POR_CAPAS) {
+            while (frenteVivo && (i < 0 || !visto.prueba(i / tam(), i % tam()))) avanzarCapa();
+        } else {
+            while (cabeza < finCola && (i < 0 || dist[i] == INALCANZABLE)) {
+                int u = cola[cabeza++];
+                int32_t d = dist[u] + 1;
+                // Sin saltos: qué vecinos son nuevos es impredecible
+                vecinos(u, [&](int v) {
+                    bool nuevo = dist[v] == INALCANZABLE;
+                    dist[v] = nuevo ? d : dist[v];
+                    cola[finCola] = v;
+                    finCola += nuevo;
+                });
+            }
+        }
+    }
+
+    // ¿Está la casilla en la capa d? (tablero fijo)
+    bool enCapa(int d, int fila, int col) const {
+        return (capas[d * PALABRAS + Plano::palabra(fila)] >> Plano::desplazamiento(fila, col)) & 1u;
+    }
+
+    // Distancia ya calculada de la casilla i (tras expandirHasta)
+    int32_t leer(int i) const {
+        if constexpr (POR_CAPAS) {
+            int f = i / tam(), c = i % tam();
+            if (!visto.prueba(f, c)) return libre.prueba(f, c) ? INALCANZABLE : BLOQUEADA;
+            int32_t d = 0;
+            while (!enCapa(d, f, c)) d++;
+            return d;
+        } else {
+            return dist[i];
+        }
+    }
+
+    // Aplica los cambios del mapa desde la última vez. Devuelve false si hay que
+    // reconstruir.
+    bool reparar(const MapaT<Cfg>& mapa) {
+        // Si ningún cambio afecta a la regla ni a los destinos (una fruta
+        // recogida, para un enemigo), el campo sigue valiendo con la BFS a medias
+        bool relevante = false;
+        if (!mapa.paraCadaCambioDesde(versionVista, [&](int f, int c) {
+                int32_t antes = leer(f * tam() + c);
+                bool cerrada = !mapa.pasable(regla, f, c);
+                relevante = relevante || cerrada != (antes == BLOQUEADA) ||
+                            (!cerrada && esDestino(mapa, f, c) != (antes == 0));
+            }))
+            return false;
+        if (!relevante) return true;
+        if constexpr (POR_CAPAS) return false;
+        else return repararCasillas(mapa);
+    }
+
+    // Reparación casilla a casilla de dist[]; false si se cerró la raíz o si
+    // tocaría tantas casillas que reconstruir sale más barato
+    bool repararCasillas(const MapaT<Cfg>& mapa) {
+        expandirHasta(-1);
+        pendientes.clear();
+        invalidas.clear();
+        destinosNuevos.clear();
+        bool raizCerrada = false;
+        mapa.paraCadaCambioDesde(versionVista, [&](int f, int c) {
+            int i = f * tam() + c;
+            int32_t antes = dist[i];
+            bool valida = antes != BLOQUEADA && antes != INALCANZABLE;
+            if (!mapa.pasable(regla, f, c)) {
+                if (antes == BLOQUEADA) return;
+                if (i == raiz) raizCerrada = true;
+                if (valida) invalidas.push_back({i, antes});
+                dist[i] = BLOQUEADA;
+            } else if (esDestino(mapa, f, c)) {
+                // Una distancia que baja a 0 no deja a nadie sin apoyo
+                if (antes == 0) return;
+                if (antes == BLOQUEADA) dist[i] = INALCANZABLE;
+                destinosNuevos.push_back(i);
+            } else if (antes == BLOQUEADA || antes == 0) {
+                if (antes == 0) invalidas.push_back({i, 0});
+                dist[i] = INALCANZABLE;
+                pendientes.push_back(i);
+            }
+        });
+        if (raizCerrada) return false;
+
+        // Invalidar las casillas que ya no tienen un vecino a distancia d-1. Si
+        // caen más de un octavo del tablero (perder un destino suele arrastrar
+        // toda su zona), se reconstruye.
+        const size_t tope = dist.size() / 8;
+        while (!invalidas.empty()) {
+            if (pendientes.size() > tope) return false;
+            auto [u, du] = invalidas.back();
+            invalidas.pop_back();
+            vecinos(u, [&](int v) {
+                if (dist[v] != du + 1) return;
+                bool apoyo = false;
+                vecinos(v, [&](int w) { apoyo = apoyo || dist[w] == du; });
+                if (apoyo) return;
+                dist[v] = INALCANZABLE;
+                invalidas.push_back({v, du + 1});
+                pendientes.push_back(v);
+            });
+        }
+
+        // Semillas: cada casilla pendiente toma la mejor distancia de sus vecinos
+        // válidos, y cada destino nuevo parte de 0; desde ahí, Dijkstra con
+        // pesos unitarios
+        monticulo.clear();
+        for (int p : pendientes) {
+            if (dist[p] != INALCANZABLE) continue;
+            int32_t mejor = INALCANZABLE;
+            vecinos(p, [&](int v) {
+                if (dist[v] >= 0 && dist[v] != INALCANZABLE) mejor = std::min(mejor, dist[v] + 1);
+            });
+            if (mejor != INALCANZABLE) monticulo.push_back({mejor, p});
+        }
+        for (int p : destinosNuevos) monticulo.push_back({0, p});
+        auto mayor = std::greater<std::pair<int32_t, int>>();
+        std::make_heap(monticulo.begin(), monticulo.end(), mayor);
+        while (!monticulo.empty()) {
+            std::pop_heap(monticulo.begin(), monticulo.end(), mayor);
+            auto [d, u] = monticulo.back();
+            monticulo.pop_back();
+            if (d >= dist[u]) continue;
+            dist[u] = d;
+            vecinos(u, [&](int v) {
+                if (dist[v] > d + 1) {
+                    monticulo.push_back({d + 1, v});
+                    std::push_heap(monticulo.begin(), monticulo.end(), mayor);
+                }
+            });
+        }
+        return true;
+    }
+
+    // Repara el campo si el destino es el mismo y el mapa no se regeneró; si
+    // no, fija el destino nuevo y lo reconstruye
+    template <class FijarDestino>
+    void ajustar(const MapaT<Cfg>& mapa, bool mismoDestino, FijarDestino&& fijarDestino) {
+        bool reutilizable = construido && mismoDestino && mapa.generacion() == generacionVista;
+        if (!reutilizable || (mapa.version() != versionVista && !reparar(mapa))) {
+            fijarDestino();
+            reconstruir(mapa);
+        }
+        construido = true;
+        generacionVista = mapa.generacion();
+        versionVista = mapa.version();
+    }
+
+public:
+    explicit CampoDistancias(ReglaPaso r, const Cfg& c = Cfg()) : cfg(c), regla(r) {}
+
+    // Obliga a reconstruirlo en la siguiente consulta (el mapa ha vuelto atrás)
+    void invalidar() { construido = false; }
+
+    // Deja el campo al día hacia el jugador en (fila, col)
+    void actualizar(const MapaT<Cfg>& mapa, int fila, int col) {
+        int r = fila * tam() + col;
+        ajustar(mapa, !haciaFrutas && r == raiz, [&] {
+            haciaFrutas = false;
+            raiz = r;
+        });
+    }
+    // Deja el campo al día hacia la fruta recogible más cercana
+    void actualizarHaciaFrutas(const MapaT<Cfg>& mapa) {
+        ajustar(mapa, haciaFrutas, [&] {
+            haciaFrutas = true;
+            raiz = -1;
+        });
+    }
+
+    int32_t distancia(int fila, int col) {
+        int i = fila * tam() + col;
+        expandirHasta(i);
+        return leer(i);
+    }
+
+    // Paso que acerca al destino desde (fila, col); Ninguna si no hay camino
+    // o ya se está en él
+    Direccion siguientePaso(int fila, int col) {
+        int i = fila * tam() + col;
+        expandirHasta(i);
+        int32_t d = leer(i);
+        if (d <= 0 || d == INALCANZABLE) return Ninguna;
+        if constexpr (POR_CAPAS) {
+            // El primer vecino de la capa anterior, en el orden de Direccion
+            if (enCapa(d - 1, fila - 1, col)) return Arriba;
+            if (enCapa(d - 1, fila + 1, col)) return Abajo;
+            if (enCapa(d - 1, fila, col - 1)) return Izquierda;
+            if (enCapa(d - 1, fila, col + 1)) return Derecha;
+            return Ninguna;
+        } else {
+            Direccion mejor = Ninguna;
+            int k = 0;
+            vecinos(i, [&](int v) {
+                if (mejor == Ninguna && dist[v] == d - 1) mejor = static_cast<Direccion>(k);
+                k++;
+            });
+            return mejor;
+        }
+    }
+};
+
+#endif // NUCLEO_CAMPODISTANCIAS_H
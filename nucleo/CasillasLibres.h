@@ -0,0 +1,60 @@
+#ifndef NUCLEO_CASILLASLIBRES_H
+#define NUCLEO_CASILLASLIBRES_H
+
+#include <cstdint>
+
+#include "Aleatorio.h"
+#include "Config.h"
+
+// Conjunto de casillas (índices 0..n-1) donde aún se puede poner algo, con
+// sorteo uniforme, alta, baja y consulta en O(1): la lista densa de las que
+// están y, por casilla, su puesto en ella. Quitar mueve la última al hueco.
+// Sustituye al sorteo con reintentos, que se alarga cuanto más lleno está el
+// tablero. N como en Almacen (DINAMICO para tableros de lado variable).
+template <int N>
+class CasillasLibres {
+    static constexpr int32_t FUERA = -1;
+
+    Almacen<int32_t, N> lista;
+    Almacen<int32_t, N> puesto; // índice en lista, o FUERA
+    int cuantas = 0;
+    int total = -1; // n del último reiniciar()
+
+public:
+    // Vacío, para las casillas 0..n-1. Con el mismo n que la vez anterior
+    // solo se limpian las que quedaban dentro: se puede reutilizar por nivel
+    // sin recorrer el tablero entero.
+    void reiniciar(int n) {
+        if (n == total) {
+            for (int i = 0; i < cuantas; i++) puesto[lista[i]] = FUERA;
+        } else {
+            dimensionar(lista, n);
+            dimensionar(puesto, n);
+            for (int i = 0; i < n; i++) puesto[i] = FUERA;
+            total = n;
+        }
+        cuantas = 0;
+    }
+
+    int tamano() const { return cuantas; }
+    bool vacio() const { return cuantas == 0; }
+    bool contiene(int c) const { return puesto[c] != FUERA; }
+
+    void agregar(int c) {
+        if (contiene(c)) return;
+        puesto[c] = cuantas;
+        lista[cuantas++] = c;
+    }
+    void quitar(int c) {
+        if (!contiene(c)) return;
+        int32_t ultima = lista[--cuantas];
+        lista[puesto[c]] = ultima;
+        puesto[ultima] = puesto[c];
+        puesto[c] = FUERA;
+    }
+
+    // Una casilla cualquiera del conjunto, todas con la misma probabilidad (no vacío)
+    int sortear(Aleatorio& rng) const { return lista[rng.acotado(cuantas)]; }
+};
+
+#endif // NUCLEO_CASILLASLIBRES_H
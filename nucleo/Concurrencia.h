@@ -0,0 +1,78 @@
+#ifndef NUCLEO_CONCURRENCIA_H
+#define NUCLEO_CONCURRENCIA_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Tamaño de línea de caché supuesto para separar lo que escribe cada hilo
+constexpr int LINEA_CACHE = 64;
+
+// Cola circular de capacidad N (potencia de 2) entre exactamente un hilo que
+// mete y uno que saca, sin cerrojos. Cada índice solo lo escribe un lado; el
+// otro lo lee con acquire, lo que publica también el dato del hueco.
+template <class T, int N>
+class ColaSPSC {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "ColaSPSC necesita una capacidad potencia de 2");
+
+    std::array<T, N> datos{};
+    alignas(LINEA_CACHE) std::atomic<uint32_t> cabeza{0}; // siguiente a sacar (consumidor)
+    alignas(LINEA_CACHE) std::atomic<uint32_t> cola{0};   // siguiente hueco libre (productor)
+
+public:
+    // Productor: false si la cola está llena
+    bool meter(const T& v) {
+        uint32_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabeza.load(std::memory_order_acquire) == static_cast<uint32_t>(N)) return false;
+        datos[c & (N - 1)] = v;
+        cola.store(c + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumidor: false si no hay nada
+    bool sacar(T& v) {
+        uint32_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == cola.load(std::memory_order_acquire)) return false;
+        v = datos[h & (N - 1)];
+        cabeza.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Triple búfer sin cerrojos: el productor escribe siempre en su copia y la
+// publica intercambiándola con la intermedia; el consumidor, cuando hay una
+// nueva, cambia la suya por la intermedia. Ninguno espera al otro y el
+// consumidor ve siempre un T completo (el último publicado), nunca uno a
+// medio escribir.
+template <class T>
+class TripleBuffer {
+    static constexpr uint8_t INDICE = 0x3;
+    static constexpr uint8_t NUEVO = 0x4; // la intermedia aún no se ha leído
+
+    struct alignas(LINEA_CACHE) Hueco {
+        T valor{};
+    };
+    Hueco huecos[3];
+    alignas(LINEA_CACHE) std::atomic<uint8_t> intermedio{1};
+    alignas(LINEA_CACHE) uint8_t escritura = 0; // solo el productor
+    alignas(LINEA_CACHE) uint8_t lectura = 2;   // solo el consumidor
+
+public:
+    // Productor
+    T& paraEscribir() { return huecos[escritura].valor; }
+    void publicar() {
+        uint8_t anterior = intermedio.exchange(static_cast<uint8_t>(escritura | NUEVO), std::memory_order_acq_rel);
+        escritura = anterior & INDICE;
+    }
+
+    // Consumidor: true si había una versión nueva y ahora leer() la devuelve
+    bool recoger() {
+        if (!(intermedio.load(std::memory_order_relaxed) & NUEVO)) return false;
+        uint8_t anterior = intermedio.exchange(lectura, std::memory_order_acq_rel);
+        lectura = anterior & INDICE;
+        return true;
+    }
+    const T& leer() const { return huecos[lectura].valor; }
+};
+
+#endif // NUCLEO_CONCURRENCIA_H
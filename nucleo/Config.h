@@ -0,0 +1,83 @@
+#ifndef NUCLEO_CONFIG_H
+#define NUCLEO_CONFIG_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Constantes.h"
+
+// Marca de una dimensión que no se conoce hasta ejecutar
+constexpr int DINAMICO = -1;
+
+// Almacen<T, N>: std::array<T, N> dentro del propio objeto, o std::vector<T>
+// cuando N es DINAMICO
+template <class T, int N>
+struct AlmacenSel { using tipo = std::array<T, N>; };
+template <class T>
+struct AlmacenSel<T, DINAMICO> { using tipo = std::vector<T>; };
+template <class T, int N>
+using Almacen = typename AlmacenSel<T, N>::tipo;
+
+// El arreglo fijo ya tiene su tamaño; el vector se ajusta sin tocar lo que ya tenía
+template <class T, size_t N>
+void dimensionar(std::array<T, N>&, int) {}
+template <class T>
+void dimensionar(std::vector<T>& v, int n) { v.resize(static_cast<size_t>(n)); }
+
+// Celdas de un tablero de lado Tam (DINAMICO si el lado lo es)
+constexpr int celdasTablero(int tam) { return tam == DINAMICO ? DINAMICO : tam * tam; }
+
+// Densidad de referencia del juego original: lo que se reparte en las 13x13
+// casillas interiores del tablero clásico se escala con el área en los demás
+constexpr int CELDAS_INTERIOR_CLASICO = (TAM_TABLERO - 2) * (TAM_TABLERO - 2);
+
+// Tamaños fijados al compilar. Mapa, Ocupacion y Juego usan arreglos de
+// tamaño fijo y el compilador pliega todos los límites, así el tablero de
+// 15x15 genera el mismo código que con las constantes globales. El lado cabe
+// como mucho en una fila de PlanoBits (16 casillas).
+template <int Tam, int MaxEnemigos, int MaxFrutas>
+struct ConfigFija {
+    static constexpr int TAM = Tam;
+    static constexpr int MAX_ENEMIGOS = MaxEnemigos;
+    static constexpr int MAX_FRUTAS = MaxFrutas;
+
+    static constexpr int tam() { return Tam; }
+    static constexpr int maxEnemigos() { return MaxEnemigos; }
+    static constexpr int maxFrutas() { return MaxFrutas; }
+
+    // Reparto por nivel del juego original
+    static constexpr int enemigosNivel(int nivel) { return std::min(nivel, MaxEnemigos); }
+    static constexpr int uvasNivel(int nivel) { return std::min(std::min(5 + nivel * 2, 15), MaxFrutas); }
+};
+
+using ConfigClasica = ConfigFija<TAM_TABLERO, MAX_ENEMIGOS, MAX_FRUTAS>;
+
+// Tamaños leídos en ejecución, para mapas grandes (64x64 hasta 1024x1024) con
+// cientos de enemigos. Los contenedores pasan a std::vector y PlanoBits usa
+// filas de varias palabras.
+struct ConfigDinamica {
+    static constexpr int TAM = DINAMICO;
+    static constexpr int MAX_ENEMIGOS = DINAMICO;
+    static constexpr int MAX_FRUTAS = DINAMICO;
+
+    int lado = 64;
+    int topeEnemigos = 512;
+    int topeFrutas = 1 << 16;
+    int enemigosPorNivel = 16;
+
+    int tam() const { return lado; }
+    int maxEnemigos() const { return topeEnemigos; }
+    int maxFrutas() const { return topeFrutas; }
+
+    int enemigosNivel(int nivel) const { return std::min(nivel * enemigosPorNivel, topeEnemigos); }
+    // Misma densidad de fruta que el tablero clásico en ese nivel
+    int uvasNivel(int nivel) const {
+        long long interior = static_cast<long long>(lado - 2) * (lado - 2);
+        long long n = interior * ConfigClasica::uvasNivel(nivel) / CELDAS_INTERIOR_CLASICO;
+        return static_cast<int>(std::min<long long>(n, topeFrutas));
+    }
+};
+
+#endif // NUCLEO_CONFIG_H
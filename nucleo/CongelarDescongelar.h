@@ -0,0 +1,72 @@
+#ifndef NUCLEO_CONGELARDESCONGELAR_H
+#define NUCLEO_CONGELARDESCONGELAR_H
+
+#include "Mapa.h"
+#include "Ocupacion.h"
+
+// Los rayos trabajan sobre la fila o columna completa del jugador como máscara
+// de bits: se busca el primer obstáculo con ctz/clz, bloque a bloque en los
+// tableros grandes, y el tramo intermedio se congela (o descongela) de una vez
+// en el Mapa.
+class CongelarDescongelar {
+    struct Rayo {
+        bool horizontal; // recorre la fila del jugador (si no, su columna)
+        int linea;       // índice de esa fila o columna
+        int pos;         // posición del jugador dentro de la línea
+        bool avanza;     // hacia índices mayores (Abajo / Derecha)
+    };
+
+    static Rayo rayoDesde(const Jugador& jug) {
+        int jr = jug.pos.celdaY(), jc = jug.pos.celdaX();
+        switch (jug.dir) {
+            case Abajo: return {false, jc, jr, true};
+            case Izquierda: return {true, jr, jc, false};
+            case Derecha: return {true, jr, jc, true};
+            default: return {false, jc, jr, false}; // Arriba (y sin dirección)
+        }
+    }
+
+    // Casillas [desde, hasta) entre el jugador y el primer obstáculo
+    static void tramo(const Rayo& r, int obstaculo, int& desde, int& hasta) {
+        desde = r.avanza ? r.pos + 1 : obstaculo + 1;
+        hasta = r.avanza ? obstaculo : r.pos;
+    }
+
+    // Marca la fruta que está en la posición 'k' de la línea del rayo
+    template <class Cfg>
+    static void marcarFruta(const Rayo& r, int k, const OcupacionT<Cfg>& ocupacion, Fruta* frutas, bool congelada) {
+        int fila = r.horizontal ? r.linea : k, col = r.horizontal ? k : r.linea;
+        int idx = ocupacion.frutaEn(fila, col);
+        if (idx != OcupacionT<Cfg>::SIN_FRUTA) frutas[idx].congelada = congelada;
+    }
+
+public:
+    template <class Cfg>
+    static void congelar(Jugador& jug, MapaT<Cfg>& mapa, OcupacionT<Cfg>& ocupacion, Fruta* frutas) {
+        Rayo r = rayoDesde(jug);
+        // El rayo se corta en muros (el borde lo es) y en enemigos
+        const auto& muros = mapa.plano(Muro);
+        const auto& enemigos = ocupacion.planoEnemigos();
+        int obstaculo = primerBloqueo([&](int k) {
+            return muros.bloque(r.horizontal, r.linea, k) | enemigos.bloque(r.horizontal, r.linea, k);
+        }, r.pos, r.avanza);
+        int desde, hasta;
+        tramo(r, obstaculo, desde, hasta);
+        mapa.congelarTramo(r.horizontal, r.linea, desde, hasta,
+                           [&](int k) { marcarFruta(r, k, ocupacion, frutas, true); });
+    }
+
+    template <class Cfg>
+    static void descongelar(Jugador& jug, MapaT<Cfg>& mapa, OcupacionT<Cfg>& ocupacion, Fruta* frutas) {
+        Rayo r = rayoDesde(jug);
+        const auto& muros = mapa.plano(Muro);
+        int obstaculo = primerBloqueo([&](int k) { return muros.bloque(r.horizontal, r.linea, k); },
+                                      r.pos, r.avanza);
+        int desde, hasta;
+        tramo(r, obstaculo, desde, hasta);
+        mapa.descongelarTramo(r.horizontal, r.linea, desde, hasta,
+                              [&](int k) { marcarFruta(r, k, ocupacion, frutas, false); });
+    }
+};
+
+#endif // NUCLEO_CONGELARDESCONGELAR_H
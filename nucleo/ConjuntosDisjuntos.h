@@ -0,0 +1,44 @@
+#ifndef NUCLEO_CONJUNTOSDISJUNTOS_H
+#define NUCLEO_CONJUNTOSDISJUNTOS_H
+
+#include <cstdint>
+#include <utility>
+
+#include "Config.h"
+
+// Unión-búsqueda sobre los índices 0..n-1, con unión por tamaño y búsqueda
+// con compresión a medias: cada operación cuesta O(α(n)), en la práctica
+// constante. padre[x] < 0 marca una raíz y guarda menos el tamaño de su
+// conjunto. N como en Almacen (DINAMICO para tableros de lado variable).
+template <int N>
+class ConjuntosDisjuntos {
+    Almacen<int32_t, N> padre;
+
+public:
+    // Cada índice en su propio conjunto
+    void reiniciar(int n) {
+        dimensionar(padre, n);
+        for (int i = 0; i < n; i++) padre[i] = -1;
+    }
+
+    int raiz(int x) {
+        while (padre[x] >= 0) {
+            if (padre[padre[x]] >= 0) padre[x] = padre[padre[x]];
+            x = padre[x];
+        }
+        return x;
+    }
+
+    // false si ya estaban juntos
+    bool unir(int a, int b) {
+        a = raiz(a);
+        b = raiz(b);
+        if (a == b) return false;
+        if (padre[a] > padre[b]) std::swap(a, b);
+        padre[a] += padre[b];
+        padre[b] = a;
+        return true;
+    }
+};
+
+#endif // NUCLEO_CONJUNTOSDISJUNTOS_H
@@ -0,0 +1,21 @@
+#ifndef NUCLEO_CONSTANTES_H
+#define NUCLEO_CONSTANTES_H
+
+const int TAM_TABLERO = 15;
+// Pasos de simulación por segundo (Juego::ticksPorSegundo lo cambia por
+// partida). Las velocidades van en casillas por segundo.
+const int TICKS_POR_SEGUNDO = 5;
+// Tope del ritmo que se acepta de fuera: más rápido, los pasos bajan del
+// milisegundo y la velocidad por tick se queda en casi nada
+const int MAX_TICKS_POR_SEGUNDO = 240;
+const float VEL_JUGADOR = 5.0f;
+const float VEL_ENEMIGO_ESPECIAL = 3.0f;
+const float VEL_ENEMIGO_NORMAL = 3.0f;
+const int MAX_ENEMIGOS = 6;
+const int MAX_FRUTAS = 30;
+// Niveles 1..MAX_NIVEL; lo que llega de fuera (repeticiones, red, paquetes)
+// con otro número se rechaza
+const int MAX_NIVEL = 15;
+const float PROB_PERSECUCION = 0.8f;
+
+#endif // NUCLEO_CONSTANTES_H
@@ -0,0 +1,89 @@
+#include "DueloRed.h"
+
+#include <utility>
+
+#include "Varint.h"
+
+namespace {
+
+constexpr char MAGIA[2] = {'I', 'C'};
+constexpr uint64_t MAX_INT = 0x7FFFFFFF;
+
+// Enteros con signo en varint: 0, -1, 1, -2... pasan a 0, 1, 2, 3...
+uint64_t zigzag(int v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+
+int desdeZigzag(uint64_t v) {
+    uint32_t u = static_cast<uint32_t>(v);
+    return static_cast<int>((u >> 1) ^ (0u - (u & 1)));
+}
+
+} // namespace
+
+std::vector<uint8_t> MensajeRed::codificar() const {
+    std::vector<uint8_t> b(MAGIA, MAGIA + 2);
+    b.push_back(VERSION);
+    b.push_back(tipo);
+    if (tipo == Inicio) {
+        escribirVarint(b, static_cast<uint64_t>(nivel));
+        escribirVarint(b, semilla);
+        escribirVarint(b, static_cast<uint64_t>(ticksPorSegundo));
+        escribirVarint(b, static_cast<uint64_t>(retardo));
+    } else if (tipo == Entradas) {
+        b.reserve(24 + entradas.size() * 2);
+        escribirVarint(b, static_cast<uint64_t>(tick));
+        escribirVarint(b, zigzag(ventaja));
+        escribirVarint(b, static_cast<uint64_t>(confirmado));
+        escribirVarint(b, static_cast<uint64_t>(primero));
+        escribirVarint(b, entradas.size());
+        for (const auto& e : entradas) {
+            b.push_back(e.num);
+            b.insert(b.end(), e.codigos, e.codigos + e.num);
+        }
+        escribirVarint(b, static_cast<uint64_t>(tickHuella + 1));
+        if (tickHuella >= 0) escribirVarint(b, huella);
+    }
+    return b;
+}
+
+bool MensajeRed::decodificar(const uint8_t* datos, size_t n, MensajeRed& m) {
+    const uint8_t* p = datos;
+    const uint8_t* fin = datos + n;
+    if (n < 4 || p[0] != MAGIA[0] || p[1] != MAGIA[1] || p[2] != VERSION) return false;
+    MensajeRed leido;
+    if (p[3] < Hola || p[3] > Entradas) return false;
+    leido.tipo = static_cast<Tipo>(p[3]);
+    p += 4;
+
+    if (leido.tipo == Inicio) {
+        if (!leerEntero(p, fin, leido.nivel, MAX_NIVEL) || leido.nivel < 1 || !leerVarint(p, fin, leido.semilla) ||
+            !leerEntero(p, fin, leido.ticksPorSegundo, MAX_TICKS_POR_SEGUNDO) || leido.ticksPorSegundo == 0 ||
+            !leerEntero(p, fin, leido.retardo, SesionRollback::MAX_RETARDO))
+            return false;
+    } else if (leido.tipo == Entradas) {
+        uint64_t ventaja, num;
+        int tickHuellaMas1;
+        // primero + k, el tick de cada entrada, tiene que caber en un int
+        if (!leerEntero(p, fin, leido.tick, MAX_INT) || !leerVarint(p, fin, ventaja) || ventaja > 0xFFFFFFFF ||
+            !leerEntero(p, fin, leido.confirmado, MAX_INT) ||
+            !leerEntero(p, fin, leido.primero, MAX_INT - MAX_ENTRADAS) ||
+            !leerVarint(p, fin, num) || num > static_cast<uint64_t>(MAX_ENTRADAS))
+            return false;
+        leido.ventaja = desdeZigzag(ventaja);
+        leido.entradas.resize(num);
+        for (auto& e : leido.entradas) {
+            if (p == fin || *p > EntradaTick::MAX_ORDENES || fin - p < 1 + *p) return false;
+            e.num = *p++;
+            for (int k = 0; k < e.num; k++) {
+                Orden o;
+                if (!ordenDeCodigo(*p, o)) return false;
+                e.codigos[k] = *p++;
+            }
+        }
+        if (!leerEntero(p, fin, tickHuellaMas1, MAX_INT)) return false;
+        leido.tickHuella = tickHuellaMas1 - 1;
+        if (leido.tickHuella >= 0 && !leerVarint(p, fin, leido.huella)) return false;
+    }
+    if (p != fin) return false;
+    m = std::move(leido);
+    return true;
+}
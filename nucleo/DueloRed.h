@@ -0,0 +1,249 @@
+#ifndef NUCLEO_DUELORED_H
+#define NUCLEO_DUELORED_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "Aleatorio.h"
+#include "Rollback.h"
+
+// Datagrama del duelo en red. El invitado manda Hola hasta que el anfitrión
+// le contesta con Inicio (nivel, semilla y ritmo de la partida); desde ahí
+// los dos mandan Entradas una vez por frame.
+//
+// Formato: "IC" versión tipo, y según el tipo (enteros en varint):
+//   Inicio:   nivel semilla ticksPorSegundo retardo, con nivel en
+//             1..MAX_NIVEL, ritmo en 1..MAX_TICKS_POR_SEGUNDO y retardo en
+//             0..MAX_RETARDO (lo demás se descarta)
+//   Entradas: tick ventaja(zigzag) confirmado primero num, por entrada
+//             num códigos(1 byte cada uno), y tickHuella+1 [huella]
+// Cada Entradas repite todas las entradas propias que el otro aún no ha
+// confirmado, así un datagrama perdido no obliga a reenviar nada.
+struct MensajeRed {
+    enum Tipo : uint8_t { Hola = 1, Inicio = 2, Entradas = 3 };
+    static constexpr uint8_t VERSION = 3;
+    static constexpr int MAX_ENTRADAS = 64;
+
+    Tipo tipo = Hola;
+    // Inicio
+    int nivel = 1;
+    uint64_t semilla = 0;
+    int ticksPorSegundo = 0;
+    int retardo = 0;
+    // Entradas
+    int tick = 0;       // tick actual de quien manda
+    int ventaja = 0;    // cuánto va quien manda por delante del último tick que sabe del otro
+    int confirmado = 0; // siguiente entrada del receptor que le falta a quien manda
+    int primero = 0;    // tick de entradas[0]
+    std::vector<EntradaTick> entradas;
+    int tickHuella = -1;
+    uint64_t huella = 0;
+
+    std::vector<uint8_t> codificar() const;
+    // false (y m sin tocar) si los bytes no son un mensaje válido
+    static bool decodificar(const uint8_t* datos, size_t n, MensajeRed& m);
+};
+
+// Retraso y pérdida artificiales para probar la red en una sola máquina: lo
+// que entra sale 'latenciaNs' después (en orden), salvo los que se pierden
+class EnlaceSimulado {
+    struct Paquete {
+        int64_t salida;
+        std::vector<uint8_t> datos;
+    };
+    std::deque<Paquete> cola;
+    int64_t latenciaNs = 0;
+    int perdidaPorMil = 0;
+    Aleatorio rng;
+
+public:
+    explicit EnlaceSimulado(int64_t latencia = 0, int perdida = 0, uint64_t semilla = 1)
+        : latenciaNs(latencia), perdidaPorMil(perdida), rng(semilla) {}
+
+    void meter(std::vector<uint8_t> datos, int64_t ahoraNs) {
+        if (perdidaPorMil > 0 && rng.acotado(1000) < perdidaPorMil) return;
+        cola.push_back({ahoraNs + latenciaNs, std::move(datos)});
+    }
+
+    // f(const std::vector<uint8_t>&) con cada paquete cuyo momento ya llegó
+    template <class F>
+    void sacarListos(int64_t ahoraNs, F&& f) {
+        while (!cola.empty() && cola.front().salida <= ahoraNs) {
+            f(cola.front().datos);
+            cola.pop_front();
+        }
+    }
+};
+
+// Un extremo del duelo 1 vs 1 en red: la sesión de rollback, el reloj de
+// ticks y el protocolo, sin sockets. Quien lo usa le pasa cada datagrama que
+// llega con recibir() y, una vez por frame, llama a avanzar(), que manda lo
+// que toque por la función que recibe.
+//
+// Los dos lados arrancan con un desfase de media ida y vuelta. Para que
+// ninguno viva siempre por delante prediciendo al otro, cada mensaje lleva la
+// ventaja de quien lo manda; el que va por delante alarga un poco sus ticks
+// hasta igualarse, sin saltos.
+template <class Cfg>
+class DueloRedT {
+public:
+    struct Partida {
+        int nivel = 5;
+        uint64_t semilla = 0;
+        int ticksPorSegundo = 60;
+        int retardo = 2; // ticks entre una tecla y su efecto, en los dos lados
+    };
+    static constexpr int64_t NS_REINTENTO_HOLA = 100000000; // 100 ms
+    static constexpr int MAX_PASOS_SEGUIDOS = 5;
+    // Lo que se alarga un tick por cada tick de ventaja (en octavos)
+    static constexpr int FRENO_OCTAVOS = 1;
+    static constexpr int MAX_FRENO_TICKS = 4;
+
+    // El anfitrión fija la partida, llevada a lo que el invitado acepta en
+    // Inicio (si no, el invitado lo descartaría y esperaría para siempre); la
+    // del invitado llega con Inicio
+    DueloRedT(JuegoT<Cfg>* local, JuegoT<Cfg>* remoto, bool esAnfitrion, const Partida& p = Partida())
+        : anfitrion(esAnfitrion),
+          partida(acotada(p)),
+          sesion(esAnfitrion ? local : remoto, esAnfitrion ? remoto : local, esAnfitrion ? 0 : 1) {}
+
+    bool enMarcha() const { return arrancado; }
+    const Partida& datosPartida() const { return partida; }
+    const SesionRollbackT<Cfg>& sesionRollback() const { return sesion; }
+    int64_t nsPorPaso() const { return nsPaso; }
+    int64_t instanteUltimoTick() const { return ultimoTickNs; }
+    // Ticks por delante del otro, ya descontada la latencia (negativo si va por detrás)
+    int ventajaEstimada() const { return (ventajaLocal() - ventajaRemota) / 2; }
+
+    bool ordenLocal(const Orden& o) { return arrancado && sesion.ordenLocal(o); }
+
+    void recibir(const uint8_t* datos, size_t n, int64_t ahoraNs) {
+        MensajeRed m;
+        if (!MensajeRed::decodificar(datos, n, m)) return;
+        switch (m.tipo) {
+            case MensajeRed::Hola:
+                if (!anfitrion) break;
+                if (!arrancado) arrancar(ahoraNs);
+                responderInicio = true;
+                break;
+            case MensajeRed::Inicio:
+                if (anfitrion || arrancado) break;
+                partida.nivel = m.nivel;
+                partida.semilla = m.semilla;
+                partida.ticksPorSegundo = m.ticksPorSegundo;
+                partida.retardo = m.retardo;
+                arrancar(ahoraNs);
+                break;
+            case MensajeRed::Entradas:
+                if (!arrancado) break;
+                for (size_t k = 0; k < m.entradas.size(); k++)
+                    sesion.entradaRemota(m.primero + static_cast<int>(k), m.entradas[k]);
+                acuseRemoto = std::max(acuseRemoto, m.confirmado);
+                if (m.tick >= tickRemoto) {
+                    tickRemoto = m.tick;
+                    ventajaRemota = m.ventaja;
+                }
+                if (m.tickHuella >= 0) sesion.comprobarHuella(m.tickHuella, m.huella);
+                break;
+        }
+    }
+
+    // Resuelve las vueltas atrás pendientes, avanza los ticks que tocan a
+    // 'ahoraNs' y manda el mensaje del frame con enviar(std::vector<uint8_t>).
+    // Devuelve los ticks avanzados.
+    template <class F>
+    int avanzar(int64_t ahoraNs, F&& enviar) {
+        if (!arrancado) {
+            if (!anfitrion && ahoraNs >= siguienteHolaNs) {
+                MensajeRed hola;
+                enviar(hola.codificar());
+                siguienteHolaNs = ahoraNs + NS_REINTENTO_HOLA;
+            }
+            return 0;
+        }
+        if (responderInicio) {
+            MensajeRed inicio;
+            inicio.tipo = MensajeRed::Inicio;
+            inicio.nivel = partida.nivel;
+            inicio.semilla = partida.semilla;
+            inicio.ticksPorSegundo = partida.ticksPorSegundo;
+            inicio.retardo = partida.retardo;
+            enviar(inicio.codificar());
+            responderInicio = false;
+        }
+
+        sesion.resolver();
+        int n = 0;
+        while (ahoraNs >= siguienteTickNs) {
+            if (n == MAX_PASOS_SEGUIDOS) {
+                siguienteTickNs = ahoraNs; // el tiempo que falta se da por perdido
+                break;
+            }
+            if (!sesion.avanzar()) {
+                siguienteTickNs = ahoraNs; // esperando al otro: se reintenta en el siguiente frame
+                break;
+            }
+            ultimoTickNs = siguienteTickNs;
+            int freno = std::min(std::max(ventajaEstimada(), 0), MAX_FRENO_TICKS) * FRENO_OCTAVOS;
+            siguienteTickNs += nsPaso + nsPaso * freno / 8;
+            n++;
+        }
+        enviar(mensajeEntradas().codificar());
+        return n;
+    }
+
+private:
+    bool anfitrion;
+    Partida partida;
+    SesionRollbackT<Cfg> sesion;
+    bool arrancado = false;
+    bool responderInicio = false;
+    int64_t siguienteHolaNs = 0;
+    int64_t nsPaso = 1000000000LL / 60;
+    int64_t siguienteTickNs = 0;
+    int64_t ultimoTickNs = 0;
+    int acuseRemoto = 0;   // siguiente entrada propia que le falta al otro
+    int tickRemoto = 0;    // último tick que el otro dijo llevar
+    int ventajaRemota = 0;
+
+    int ventajaLocal() const { return sesion.tick() - tickRemoto; }
+
+    static Partida acotada(Partida p) {
+        p.nivel = std::min(std::max(p.nivel, 1), MAX_NIVEL);
+        p.ticksPorSegundo = std::min(std::max(p.ticksPorSegundo, 1), MAX_TICKS_POR_SEGUNDO);
+        p.retardo = std::min(std::max(p.retardo, 0), SesionRollbackT<Cfg>::MAX_RETARDO);
+        return p;
+    }
+
+    void arrancar(int64_t ahoraNs) {
+        sesion.iniciar(partida.nivel, partida.semilla, partida.ticksPorSegundo, partida.retardo);
+        nsPaso = 1000000000LL / partida.ticksPorSegundo;
+        siguienteTickNs = ultimoTickNs = ahoraNs;
+        acuseRemoto = tickRemoto = ventajaRemota = 0;
+        arrancado = true;
+    }
+
+    MensajeRed mensajeEntradas() const {
+        MensajeRed m;
+        m.tipo = MensajeRed::Entradas;
+        m.tick = sesion.tick();
+        m.ventaja = ventajaLocal();
+        m.confirmado = sesion.confirmadoRemoto();
+        int hasta = sesion.propiasFijadas();
+        int desde = std::max({acuseRemoto, hasta - SesionRollbackT<Cfg>::VENTANA + 1,
+                              hasta - MensajeRed::MAX_ENTRADAS});
+        m.primero = desde;
+        for (int t = desde; t < hasta; t++) m.entradas.push_back(sesion.entradaLocal(t));
+        m.tickHuella = sesion.tickUltimaHuella();
+        m.huella = sesion.valorUltimaHuella();
+        return m;
+    }
+};
+
+using DueloRed = DueloRedT<ConfigClasica>;
+
+#endif // NUCLEO_DUELORED_H
@@ -0,0 +1,73 @@
+#ifndef NUCLEO_ENTIDADES_H
+#define NUCLEO_ENTIDADES_H
+
+#include <cmath>
+
+#include "Constantes.h"
+
+enum Direccion { Arriba, Abajo, Izquierda, Derecha, Ninguna };
+enum TipoCelda { Vacia, Muro, Hielo, Uva, Platano, FrutaNormal, FrutaCongelada };
+enum TipoEnemigo { Normal, Especial };
+
+struct Posicion {
+    float x = 0, y = 0;
+    Posicion() = default;
+    Posicion(float _x, float _y) : x(_x), y(_y) {}
+    int celdaX() const { return static_cast<int>(std::round(x)); }
+    int celdaY() const { return static_cast<int>(std::round(y)); }
+};
+
+struct Jugador {
+    Posicion pos;
+    Direccion dir = Ninguna;
+    float velocidad = VEL_JUGADOR; // casillas por segundo (ritmo del bot)
+    bool vivo = true;
+    int frutas_recogidas = 0;
+
+    // Cada paso es una casilla entera; la velocidad solo fija cada cuánto
+    void mover(Direccion d) {
+        dir = d;
+        switch (d) {
+            case Arriba:  pos.y -= 1; break;
+            case Abajo:   pos.y += 1; break;
+            case Izquierda: pos.x -= 1; break;
+            case Derecha:  pos.x += 1; break;
+            default: break;
+        }
+    }
+    void detener() { dir = Ninguna; }
+};
+
+struct Enemigo {
+    Posicion pos;
+    Direccion dir = Abajo;
+    TipoEnemigo tipo = Normal;
+    float velocidad = VEL_ENEMIGO_NORMAL / TICKS_POR_SEGUNDO; // casillas por tick
+    bool vivo = true;
+    int ticksParaCambiar = 0;
+
+    Enemigo() = default;
+    Enemigo(float x, float y, TipoEnemigo t, int ticksPorSegundo = TICKS_POR_SEGUNDO) : pos(x, y), tipo(t) {
+        velocidad = ((t == Especial) ? VEL_ENEMIGO_ESPECIAL : VEL_ENEMIGO_NORMAL) / ticksPorSegundo;
+    }
+    void mover() {
+        if (!vivo) return;
+        switch (dir) {
+            case Arriba:  pos.y -= velocidad; break;
+            case Abajo:   pos.y += velocidad; break;
+            case Izquierda: pos.x -= velocidad; break;
+            case Derecha:  pos.x += velocidad; break;
+            default: break;
+        }
+    }
+};
+
+struct Fruta {
+    Posicion pos;
+    TipoCelda tipoFruta = Uva;
+    bool congelada = false;
+    Fruta() = default;
+    Fruta(float x, float y, TipoCelda t) : pos(x, y), tipoFruta(t) {}
+};
+
+#endif // NUCLEO_ENTIDADES_H
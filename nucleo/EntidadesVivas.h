@@ -0,0 +1,120 @@
+#ifndef NUCLEO_ENTIDADESVIVAS_H
+#define NUCLEO_ENTIDADESVIVAS_H
+
+#include <cstdint>
+
+#include "Config.h"
+
+// Referencia estable a una entidad de EntidadesVivas: sigue valiendo aunque
+// las demás cambien de puesto y deja de valer cuando la entidad se quita,
+// aunque su ranura se vuelva a usar (la generación ya no coincide).
+struct AsaEntidad {
+    int32_t ranura = -1;
+    uint32_t generacion = 0;
+};
+
+// Entidades vivas, contiguas y sin huecos: quitar una mueve la última a su
+// puesto, así que recorrerlas es recorrer un arreglo denso que solo tiene
+// vivas. Cada una ocupa además una ranura fija, con su generación, para
+// las asas. ranuraDe guarda primero las ranuras de las vivas (en su orden)
+// y detrás las libres, que se reutilizan antes de estrenar otra.
+//
+// N como en Almacen: con N fijo todo va dentro del objeto (trivialmente
+// copiable si T lo es) y caben N; con DINAMICO crece sin tope.
+template <class T, int N>
+class EntidadesVivas {
+    Almacen<T, N> vivas{};
+    Almacen<int32_t, N> ranuraDe{};    // puesto -> ranura
+    Almacen<int32_t, N> puesto{};      // ranura -> puesto (>= cuantas si está libre)
+    Almacen<uint32_t, N> generacion{}; // ranura -> veces que se ha liberado
+    int cuantas = 0;
+    int ranuras = 0; // ranuras estrenadas
+
+    int capacidad() const { return static_cast<int>(vivas.size()); }
+    void crecer(int n) {
+        if constexpr (N == DINAMICO) {
+            dimensionar(vivas, n);
+            dimensionar(ranuraDe, n);
+            dimensionar(puesto, n);
+            dimensionar(generacion, n);
+        }
+    }
+
+public:
+    int tamano() const { return cuantas; }
+    bool vacio() const { return cuantas == 0; }
+
+    T& operator[](int i) { return vivas[i]; }
+    const T& operator[](int i) const { return vivas[i]; }
+    T* data() { return vivas.data(); }
+    const T* data() const { return vivas.data(); }
+    T* begin() { return vivas.data(); }
+    T* end() { return vivas.data() + cuantas; }
+    const T* begin() const { return vivas.data(); }
+    const T* end() const { return vivas.data() + cuantas; }
+
+    // Sitio para n sin volver a crecer (nada con N fijo)
+    void reservar(int n) {
+        if (n > capacidad()) crecer(n);
+    }
+
+    // Quita todas; sus asas dejan de valer
+    void vaciar() {
+        for (int i = 0; i < cuantas; i++) generacion[ranuraDe[i]]++;
+        cuantas = 0;
+    }
+
+    // La nueva queda la última. Con N fijo y lleno no se agrega y el asa no vale.
+    AsaEntidad agregar(const T& e) {
+        if (cuantas == capacidad()) {
+            if constexpr (N == DINAMICO) crecer(capacidad() < 8 ? 8 : capacidad() * 2);
+            else return AsaEntidad();
+        }
+        if (cuantas == ranuras) {
+            ranuraDe[ranuras] = ranuras;
+            puesto[ranuras] = ranuras;
+            generacion[ranuras] = 0;
+            ranuras++;
+        }
+        vivas[cuantas] = e;
+        return asa(cuantas++);
+    }
+
+    // Quita la del puesto i; la última pasa a ocupar ese puesto
+    void quitar(int i) {
+        int ultima = cuantas - 1;
+        int r = ranuraDe[i], s = ranuraDe[ultima];
+        vivas[i] = vivas[ultima];
+        ranuraDe[i] = s;
+        puesto[s] = i;
+        ranuraDe[ultima] = r;
+        puesto[r] = ultima;
+        generacion[r]++;
+        cuantas--;
+    }
+
+    AsaEntidad asa(int i) const {
+        int r = ranuraDe[i];
+        return {r, generacion[r]};
+    }
+    // Puesto actual de la entidad, o -1 si ya no está
+    int puestoDe(AsaEntidad a) const {
+        if (a.ranura < 0 || a.ranura >= ranuras || generacion[a.ranura] != a.generacion) return -1;
+        return puesto[a.ranura] < cuantas ? puesto[a.ranura] : -1;
+    }
+    T* buscar(AsaEntidad a) {
+        int i = puestoDe(a);
+        return i < 0 ? nullptr : &vivas[i];
+    }
+
+    // Lo mínimo para fiarse de un bloque leído de fuera: contadores dentro
+    // de rango y ranuras y puestos que se corresponden
+    bool coherente() const {
+        if (cuantas < 0 || cuantas > ranuras || ranuras > capacidad()) return false;
+        for (int i = 0; i < ranuras; i++)
+            if (ranuraDe[i] < 0 || ranuraDe[i] >= ranuras || puesto[ranuraDe[i]] != i) return false;
+        return true;
+    }
+};
+
+#endif // NUCLEO_ENTIDADESVIVAS_H
@@ -0,0 +1,134 @@
+#ifndef NUCLEO_GUARDADO_H
+#define NUCLEO_GUARDADO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Juego.h"
+
+// Partidas guardadas en disco: una cabecera y los bytes de DatosPartidaT tal
+// cual, así cargar es una lectura y una copia. Los bytes dependen de la
+// disposición en memoria, de modo que un guardado solo vale para el mismo
+// formato: la cabecera lleva una versión (súbela al tocar DatosPartidaT o lo
+// que contiene) y el tamaño del bloque, y lo que no case se rechaza.
+//
+//   "ICSV" versión tamañoBloque lado (uint32_t cada uno) | bloque
+class Guardado {
+    static constexpr char MAGIA[4] = {'I', 'C', 'S', 'V'};
+
+    struct Cabecera {
+        char magia[4];
+        uint32_t version;
+        uint32_t tamBloque;
+        uint32_t lado;
+    };
+
+public:
+    static constexpr uint32_t VERSION = 3;
+
+    // Lo mínimo para fiarse de un bloque leído: índices y enums dentro de
+    // rango, nivel y ritmo como los que aceptan repeticiones y red, y un
+    // índice de ocupación que cuadra con las frutas y enemigos que hay
+    template <class Cfg>
+    static bool coherente(const DatosPartidaT<Cfg>& d) {
+        const int tam = d.cfg.tam();
+        auto dentro = [tam](const Posicion& p) {
+            return p.x >= 0 && p.y >= 0 && p.x <= tam - 1 && p.y <= tam - 1;
+        };
+        auto direccion = [](Direccion dir) { return dir >= Arriba && dir <= Ninguna; };
+        if (d.estado < Menu || d.estado > Perdiste) return false;
+        if (d.nivel < 1 || d.nivel > MAX_NIVEL) return false;
+        if (d.ticksPorSegundo < 1 || d.ticksPorSegundo > MAX_TICKS_POR_SEGUNDO) return false;
+        if (d.numEnemigos < 0 || d.numEnemigos > d.cfg.maxEnemigos()) return false;
+        if (!d.frutas.coherente()) return false;
+        if (d.enemigoAsesino < -1 || d.enemigoAsesino >= d.numEnemigos) return false;
+        if (!dentro(d.jugador.pos) || !direccion(d.jugador.dir) || !direccion(d.ultimaDirBot)) return false;
+        // Enemigos por casilla según sus posiciones, para compararlo con ocupacion
+        std::vector<int> enemigosEn(static_cast<size_t>(tam) * tam, 0);
+        for (int i = 0; i < d.numEnemigos; i++) {
+            const Enemigo& e = d.enemigos[i];
+            if (!dentro(e.pos) || !direccion(e.dir) || (e.tipo != Normal && e.tipo != Especial)) return false;
+            enemigosEn[e.pos.celdaY() * tam + e.pos.celdaX()]++;
+        }
+        for (const Fruta& f : d.frutas)
+            if (!dentro(f.pos)) return false;
+        // Cada casilla apunta a una fruta viva que está en ella, o a ninguna:
+        // verFrutas y los rayos escriben en frutas[] con ese índice
+        for (int r = 0; r < tam; r++)
+            for (int c = 0; c < tam; c++) {
+                int i = d.ocupacion.frutaEn(r, c);
+                if (i == OcupacionT<Cfg>::SIN_FRUTA) continue;
+                if (i < 0 || i >= d.frutas.tamano() || d.frutas[i].pos.celdaY() != r || d.frutas[i].pos.celdaX() != c)
+                    return false;
+            }
+        // Y los contadores de enemigos son exactos: saleEnemigo() en una
+        // casilla a 0 daría la vuelta al contador y dejaría un enemigo fantasma
+        for (int r = 0; r < tam; r++)
+            for (int c = 0; c < tam; c++) {
+                int n = enemigosEn[r * tam + c];
+                if (d.ocupacion.enemigosEn(r, c) != n || d.ocupacion.planoEnemigos().prueba(r, c) != (n > 0))
+                    return false;
+            }
+        return true;
+    }
+
+    // Cabecera y bloque en un solo búfer. El bloque se copia con su relleno
+    // entre campos, que no está inicializado: dos guardados de la misma
+    // partida pueden diferir en esos bytes, así que para comparar partidas
+    // se usa huellaPartida(), que recorre los campos, y no los bytes.
+    template <class Cfg>
+    static std::vector<uint8_t> codificar(const JuegoT<Cfg>& j) {
+        using Datos = DatosPartidaT<Cfg>;
+        static_assert(std::is_trivially_copyable<Datos>::value, "Solo se guardan partidas de Cfg fija");
+        Cabecera c;
+        std::memcpy(c.magia, MAGIA, sizeof(MAGIA));
+        c.version = VERSION;
+        c.tamBloque = sizeof(Datos);
+        c.lado = static_cast<uint32_t>(j.cfg.tam());
+        std::vector<uint8_t> b(sizeof(Cabecera) + sizeof(Datos));
+        std::memcpy(b.data(), &c, sizeof(c));
+        std::memcpy(b.data() + sizeof(c), &j.guardar(), sizeof(Datos));
+        return b;
+    }
+
+    // false (y la partida sin tocar) si los bytes no son un guardado de este formato
+    template <class Cfg>
+    static bool decodificar(JuegoT<Cfg>& j, const uint8_t* datos, size_t n) {
+        using Datos = DatosPartidaT<Cfg>;
+        static_assert(std::is_trivially_copyable<Datos>::value, "Solo se guardan partidas de Cfg fija");
+        Cabecera c;
+        if (n != sizeof(Cabecera) + sizeof(Datos)) return false;
+        std::memcpy(&c, datos, sizeof(c));
+        if (std::memcmp(c.magia, MAGIA, sizeof(MAGIA)) != 0 || c.version != VERSION ||
+            c.tamBloque != sizeof(Datos) || c.lado != static_cast<uint32_t>(j.cfg.tam()))
+            return false;
+        Datos d;
+        std::memcpy(&d, datos + sizeof(c), sizeof(Datos));
+        if (!coherente(d)) return false;
+        j.restaurar(d);
+        return true;
+    }
+
+    template <class Cfg>
+    static bool guardar(const JuegoT<Cfg>& j, const std::string& ruta) {
+        std::vector<uint8_t> b = codificar(j);
+        std::ofstream f(ruta, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(b.data()), static_cast<std::streamsize>(b.size()));
+        return static_cast<bool>(f);
+    }
+
+    template <class Cfg>
+    static bool cargar(JuegoT<Cfg>& j, const std::string& ruta) {
+        std::ifstream f(ruta, std::ios::binary);
+        std::vector<uint8_t> b((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        return decodificar(j, b.data(), b.size());
+    }
+};
+
+#endif // NUCLEO_GUARDADO_H
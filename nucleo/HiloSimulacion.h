@@ -0,0 +1,185 @@
+#ifndef NUCLEO_HILOSIMULACION_H
+#define NUCLEO_HILOSIMULACION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Concurrencia.h"
+#include "Juego.h"
+#include "Repeticion.h"
+
+// Reloj monótono en nanosegundos, común al hilo de simulación y a quien dibuja
+inline int64_t relojMonotonoNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Copia de lo que hace falta para dibujar una partida en un instante. La
+// produce el hilo de simulación y quien la lee solo la ve como const.
+template <class Cfg>
+struct InstantaneaT {
+    int tick = 0;           // ticksDesdeInicio
+    int64_t instanteNs = 0; // relojMonotonoNs() del último paso de lógica
+    EstadoJuego estado = Menu;
+    Jugador jugador;
+    Almacen<Enemigo, Cfg::MAX_ENEMIGOS> enemigos{};
+    int numEnemigos = 0;
+    Almacen<Fruta, Cfg::MAX_FRUTAS> frutas{};
+    int numFrutas = 0;
+    MapaT<Cfg> mapa;
+
+    void copiarDe(const JuegoT<Cfg>& j, int64_t instante) {
+        tick = j.ticksDesdeInicio;
+        instanteNs = instante;
+        estado = j.estado;
+        jugador = j.jugador;
+        numEnemigos = j.numEnemigos;
+        dimensionar(enemigos, numEnemigos);
+        for (int i = 0; i < numEnemigos; i++) enemigos[i] = j.enemigos[i];
+        numFrutas = j.frutas.tamano();
+        dimensionar(frutas, numFrutas);
+        std::copy_n(j.frutas.begin(), numFrutas, frutas.begin());
+        mapa = j.mapa;
+    }
+};
+
+// Avanza una o varias partidas en un hilo propio, a pasos fijos de
+// 1/ticksPorSegundo de segundo y todas en el mismo paso. Con el hilo en
+// marcha nadie más toca los JuegoT: las órdenes del jugador entran por una
+// ColaSPSC por partida y el estado sale en un TripleBuffer de instantáneas,
+// ninguno de los dos con cerrojos. Entre dos pasos el hilo duerme a ratos
+// cortos para aplicar las órdenes en cuanto llegan.
+template <class Cfg>
+class HiloSimulacionT {
+public:
+    using Instantanea = InstantaneaT<Cfg>;
+    static constexpr int CAPACIDAD_ORDENES = 64;
+    // Pasos seguidos como mucho si el hilo se retrasa; después da el tiempo por perdido
+    static constexpr int MAX_PASOS_SEGUIDOS = 5;
+    static constexpr int64_t SONDEO_NS = 2000000; // 2 ms
+
+    HiloSimulacionT() = default;
+    ~HiloSimulacionT() { parar(); }
+    HiloSimulacionT(const HiloSimulacionT&) = delete;
+    HiloSimulacionT& operator=(const HiloSimulacionT&) = delete;
+
+    // Solo con el hilo parado; devuelve el índice de la partida
+    int agregar(JuegoT<Cfg>* juego) {
+        partidas.push_back(std::make_unique<Partida>());
+        partidas.back()->juego = juego;
+        return static_cast<int>(partidas.size()) - 1;
+    }
+
+    // Publica el estado actual de cada partida (ya iniciada) y arranca el
+    // hilo; el ritmo sale de la primera. Las órdenes que quedaran de antes se
+    // descartan.
+    void iniciar() {
+        parar();
+        if (partidas.empty()) return;
+        nsPaso = 1000000000LL / partidas[0]->juego->ticksPorSegundo;
+        int64_t ahora = relojMonotonoNs();
+        for (auto& p : partidas) {
+            Orden o;
+            while (p->ordenes.sacar(o)) {}
+            publicar(*p, ahora);
+        }
+        corriendo.store(true, std::memory_order_release);
+        hilo = std::thread([this] { bucle(); });
+    }
+
+    // Al volver, los JuegoT vuelven a ser de quien llama y las grabaciones
+    // quedan cerradas con el resultado de la partida
+    void parar() {
+        if (!hilo.joinable()) return;
+        corriendo.store(false, std::memory_order_release);
+        hilo.join();
+        for (auto& p : partidas)
+            if (p->grabacion) p->grabacion->cerrar(*p->juego);
+    }
+
+    // Solo con el hilo parado y la partida ya iniciada. grabar() anota en r
+    // cada orden que se aplica, con su tick; reproducir() aplica las de r en
+    // su tick y descarta las que lleguen por enviar(). nullptr deja de hacerlo.
+    void grabar(int i, Repeticion* r) {
+        partidas[i]->grabacion = r;
+        if (r) r->empezar(*partidas[i]->juego);
+    }
+    void reproducir(int i, const Repeticion* r) {
+        partidas[i]->reproduccion = r;
+        partidas[i]->siguienteEvento = 0;
+    }
+
+    int64_t nsPorPaso() const { return nsPaso; }
+
+    // Desde un único hilo consumidor (la interfaz)
+    bool enviar(int i, const Orden& o) { return partidas[i]->ordenes.meter(o); }
+    bool recoger(int i) { return partidas[i]->instantaneas.recoger(); }
+    const Instantanea& instantanea(int i) const { return partidas[i]->instantaneas.leer(); }
+
+private:
+    struct Partida {
+        JuegoT<Cfg>* juego = nullptr;
+        ColaSPSC<Orden, CAPACIDAD_ORDENES> ordenes;
+        TripleBuffer<Instantanea> instantaneas;
+        bool cambiada = false; // solo el hilo de simulación
+        Repeticion* grabacion = nullptr;
+        const Repeticion* reproduccion = nullptr;
+        size_t siguienteEvento = 0;
+    };
+
+    static void publicar(Partida& p, int64_t instante) {
+        p.instantaneas.paraEscribir().copiarDe(*p.juego, instante);
+        p.instantaneas.publicar();
+        p.cambiada = false;
+    }
+
+    void bucle() {
+        int64_t ultimoPaso = relojMonotonoNs();
+        int64_t siguiente = ultimoPaso + nsPaso;
+        while (corriendo.load(std::memory_order_acquire)) {
+            for (auto& p : partidas) {
+                Orden o;
+                while (p->ordenes.sacar(o)) {
+                    if (p->reproduccion) continue;
+                    if (p->grabacion) p->grabacion->anotar(*p->juego, o);
+                    p->juego->aplicar(o);
+                    p->cambiada = true;
+                }
+            }
+            int64_t ahora = relojMonotonoNs();
+            for (int n = 0; ahora >= siguiente; n++) {
+                if (n == MAX_PASOS_SEGUIDOS) {
+                    siguiente = ahora + nsPaso;
+                    break;
+                }
+                for (auto& p : partidas) {
+                    if (p->reproduccion) aplicarEventos(*p->juego, *p->reproduccion, p->siguienteEvento);
+                    p->juego->actualizar();
+                    p->cambiada = true;
+                }
+                ultimoPaso = siguiente;
+                siguiente += nsPaso;
+            }
+            for (auto& p : partidas)
+                if (p->cambiada) publicar(*p, ultimoPaso);
+            int64_t despertar = std::min(siguiente, ahora + SONDEO_NS);
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(despertar))));
+        }
+    }
+
+    std::vector<std::unique_ptr<Partida>> partidas;
+    std::thread hilo;
+    std::atomic<bool> corriendo{false};
+    int64_t nsPaso = 1000000000LL / TICKS_POR_SEGUNDO;
+};
+
+using HiloSimulacion = HiloSimulacionT<ConfigClasica>;
+
+#endif // NUCLEO_HILOSIMULACION_H
@@ -0,0 +1,406 @@
+#ifndef NUCLEO_HORDA_H
+#define NUCLEO_HORDA_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Bitboard.h"
+#include "CampoDistancias.h"
+#include "Config.h"
+#include "LogicaEnemigo.h"
+#include "Mapa.h"
+#include "Ocupacion.h"
+
+// Modo horda: cientos o miles de enemigos en los tableros de lado variable.
+// Los enemigos se guardan por campos (un arreglo por cada uno) y los núcleos
+// de movimiento, paso y choque con el jugador avanzan varios a la vez con
+// AVX2 (8), SSE2 (4) o de uno en uno si no hay ninguno de los dos (o con
+// NUCLEO_SIN_SIMD definido). El tablero clásico sigue con su arreglo de
+// Enemigo: su estado tiene que poder copiarse byte a byte.
+#if !defined(NUCLEO_SIN_SIMD) && defined(__AVX2__)
+#define NUCLEO_HORDA_AVX2 1
+#include <immintrin.h>
+#elif !defined(NUCLEO_SIN_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define NUCLEO_HORDA_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Enemigos por campos. Cada arreglo tiene relleno hasta un múltiplo de
+// CARRILES; los carriles de relleno están muertos, así los núcleos recorren
+// bloques enteros sin comprobar el final. Un enemigo suelto se lee por valor
+// con [] y se escribe con fijar().
+class HordaEnemigos {
+    int cuantos = 0;
+
+public:
+    static constexpr int CARRILES = 8;
+
+    std::vector<float> x, y, velocidad;
+    std::vector<int32_t> dir, tipo, vivo, ticksParaCambiar;
+
+    int tamano() const { return cuantos; }
+
+    // Como dimensionar() de Almacen: lo que ya había se conserva; lo que
+    // queda del último bloque pasa a ser relleno
+    void dimensionar(int n) {
+        cuantos = n;
+        size_t total = static_cast<size_t>((n + CARRILES - 1) / CARRILES * CARRILES);
+        x.resize(total);
+        y.resize(total);
+        velocidad.resize(total);
+        dir.resize(total, Abajo);
+        tipo.resize(total, Normal);
+        vivo.resize(total, 0);
+        ticksParaCambiar.resize(total);
+        for (size_t i = static_cast<size_t>(n); i < total; i++) vivo[i] = 0;
+    }
+
+    Enemigo operator[](int i) const {
+        Enemigo e;
+        e.pos = Posicion(x[i], y[i]);
+        e.dir = static_cast<Direccion>(dir[i]);
+        e.tipo = static_cast<TipoEnemigo>(tipo[i]);
+        e.velocidad = velocidad[i];
+        e.vivo = vivo[i] != 0;
+        e.ticksParaCambiar = ticksParaCambiar[i];
+        return e;
+    }
+    void fijar(int i, const Enemigo& e) {
+        x[i] = e.pos.x;
+        y[i] = e.pos.y;
+        dir[i] = e.dir;
+        tipo[i] = e.tipo;
+        velocidad[i] = e.velocidad;
+        vivo[i] = e.vivo ? 1 : 0;
+        ticksParaCambiar[i] = e.ticksParaCambiar;
+    }
+};
+
+inline void dimensionar(HordaEnemigos& h, int n) { h.dimensionar(n); }
+
+// Los tableros con tope de enemigos elegido al ejecutar van en modo horda
+template <class Cfg>
+constexpr bool enHorda = Cfg::MAX_ENEMIGOS == DINAMICO;
+
+template <class Cfg>
+using AlmacenEnemigos =
+    typename std::conditional<enHorda<Cfg>, HordaEnemigos, Almacen<Enemigo, Cfg::MAX_ENEMIGOS>>::type;
+
+// Casillas que no puede pisar cada tipo de enemigo (pasableNormal y
+// pasableEspecial en máscara), fila a fila en palabras de 64 bits: plano de
+// Normal y a continuación el de Especial. Se reparan con el registro de
+// cambios del mapa, como los campos de distancias.
+class PasoHorda {
+    std::vector<uint64_t> bloqueadas;
+    int lado = 0;
+    int palabrasFila = 0;
+    bool construido = false;
+    uint32_t generacionVista = 0;
+    uint64_t versionVista = 0;
+
+    template <class Cfg>
+    void rehacerPalabra(const MapaT<Cfg>& mapa, int fila, int k) {
+        size_t i = static_cast<size_t>(fila) * palabrasFila + k;
+        bloqueadas[i] = mapa.intransitables(PasoNormal, true, fila, k);
+        bloqueadas[palabrasPlano() + i] = mapa.intransitables(PasoEspecial, true, fila, k);
+    }
+
+public:
+    size_t palabrasPlano() const { return static_cast<size_t>(lado) * palabrasFila; }
+
+    template <class Cfg>
+    void actualizar(const MapaT<Cfg>& mapa) {
+        if (construido && mapa.generacion() == generacionVista && mapa.tam() == lado) {
+            if (mapa.version() == versionVista) return;
+            if (mapa.paraCadaCambioDesde(versionVista, [&](int f, int c) { rehacerPalabra(mapa, f, c / 64); })) {
+                versionVista = mapa.version();
+                return;
+            }
+        }
+        lado = mapa.tam();
+        palabrasFila = (lado + 63) / 64;
+        bloqueadas.resize(2 * palabrasPlano());
+        for (int f = 0; f < lado; f++)
+            for (int k = 0; k < palabrasFila; k++) rehacerPalabra(mapa, f, k);
+        construido = true;
+        generacionVista = mapa.generacion();
+        versionVista = mapa.version();
+    }
+    void invalidar() { construido = false; }
+
+    int ladoTablero() const { return lado; }
+    int palabrasPorFila() const { return palabrasFila; }
+    const uint64_t* datos() const { return bloqueadas.data(); }
+
+    // Dentro del tablero
+    bool bloqueada(int tipo, int fila, int col) const {
+        uint64_t w = bloqueadas[static_cast<size_t>(tipo) * palabrasPlano() +
+                                static_cast<size_t>(fila) * palabrasFila + col / 64];
+        return (w >> (col % 64)) & 1u;
+    }
+};
+
+// Los núcleos de la horda. Un enemigo sigue adelante sin más (paso rápido)
+// cuando está vivo, no le toca cambiar de dirección y la casilla a la que
+// llega se puede pisar; en ese caso no usa el generador y su paso se hace en
+// bloque. Los demás pasan, en orden, por LogicaEnemigo::actualizar sobre su
+// estado sin tocar: el generador se consume en el mismo orden que enemigo a
+// enemigo y la partida es idéntica bit a bit.
+class LogicaHorda {
+public:
+#if defined(NUCLEO_HORDA_AVX2)
+    static constexpr int ANCHO = 8;
+#elif defined(NUCLEO_HORDA_SSE2)
+    static constexpr int ANCHO = 4;
+#else
+    static constexpr int ANCHO = 1;
+#endif
+    static_assert(HordaEnemigos::CARRILES % ANCHO == 0, "Un bloque no puede pasar del relleno");
+
+    // Casillas de partida y llegada de un bloque de enemigos
+    struct CeldasBloque {
+        int32_t filaAnt[ANCHO], colAnt[ANCHO], fila[ANCHO], col[ANCHO];
+    };
+
+    // Avanza los enemigos i..i+ANCHO-1. Los de paso rápido quedan movidos;
+    // los que con eso cambian de casilla se marcan en 'cambian', con la de
+    // antes y la de ahora en 'c'. Los que necesitan la lógica completa se
+    // marcan en 'resto' y no se tocan.
+    static void pasoBloque(HordaEnemigos& h, int i, const PasoHorda& paso, CeldasBloque& c, unsigned& cambian,
+                           unsigned& resto);
+
+    template <class Cfg>
+    static void actualizar(HordaEnemigos& h, int num, const Jugador& jug, MapaT<Cfg>& mapa,
+                           OcupacionT<Cfg>& ocupacion, CampoDistancias<Cfg>& campoNormal,
+                           CampoDistancias<Cfg>& campoEspecial, PasoHorda& paso, Aleatorio& rng) {
+        paso.actualizar(mapa);
+        CeldasBloque c;
+        for (int i = 0; i < num; i += ANCHO) {
+            unsigned cambian, resto;
+            pasoBloque(h, i, paso, c, cambian, resto);
+            for (; cambian; cambian &= cambian - 1) {
+                int k = bitMenor(cambian);
+                ocupacion.moverEnemigo(c.filaAnt[k], c.colAnt[k], c.fila[k], c.col[k]);
+            }
+            for (; resto; resto &= resto - 1) {
+                int k = i + bitMenor(resto);
+                Enemigo e = h[k];
+                LogicaEnemigo::actualizar(e, jug, mapa, ocupacion, e.tipo == Especial ? campoEspecial : campoNormal,
+                                          rng);
+                h.fijar(k, e);
+            }
+        }
+    }
+
+    // Primer enemigo vivo en la casilla (fila, col), o -1
+    static int primeroEnCelda(const HordaEnemigos& h, int num, int fila, int col);
+};
+
+// ---------------- Núcleos ----------------
+
+#if defined(NUCLEO_HORDA_AVX2)
+
+namespace horda_detalle {
+// std::round (mitad lejos del cero) a entero: truncar y corregir con la parte
+// fraccionaria, que es exacta en float
+inline __m256i redondear(__m256 v) {
+    __m256i t = _mm256_cvttps_epi32(v);
+    __m256 f = _mm256_sub_ps(v, _mm256_cvtepi32_ps(t));
+    __m256i arriba = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_set1_ps(0.5f), _CMP_GE_OQ));
+    __m256i abajo = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_set1_ps(-0.5f), _CMP_LE_OQ));
+    return _mm256_add_epi32(_mm256_sub_epi32(t, arriba), abajo);
+}
+inline __m256 desplazamiento(__m256i dir, __m256 vel, int menos, int mas) {
+    __m256 m = _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(dir, _mm256_set1_epi32(mas))), vel);
+    __m256 n = _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(dir, _mm256_set1_epi32(menos))), vel);
+    return _mm256_sub_ps(m, n);
+}
+// Máscara de los carriles fuera de 0..lado-1
+inline __m256i fuera(__m256i v, __m256i lado) {
+    return _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(), v),
+                           _mm256_cmpgt_epi32(v, _mm256_sub_epi32(lado, _mm256_set1_epi32(1))));
+}
+} // namespace horda_detalle
+
+inline void LogicaHorda::pasoBloque(HordaEnemigos& h, int i, const PasoHorda& paso, CeldasBloque& c,
+                                    unsigned& cambian, unsigned& resto) {
+    using namespace horda_detalle;
+    const __m256i uno = _mm256_set1_epi32(1);
+    __m256 x = _mm256_loadu_ps(&h.x[i]), y = _mm256_loadu_ps(&h.y[i]);
+    __m256 vel = _mm256_loadu_ps(&h.velocidad[i]);
+    __m256i dir = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h.dir[i]));
+    __m256i tipo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h.tipo[i]));
+    __m256i vivo = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h.vivo[i])), uno);
+    __m256i ticks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h.ticksParaCambiar[i]));
+
+    // Le toca elegir dirección si el contador llega a cero tras descontar este tick
+    __m256i agotado = _mm256_cmpgt_epi32(uno, _mm256_sub_epi32(ticks, uno));
+    __m256 nx = _mm256_add_ps(x, desplazamiento(dir, vel, Izquierda, Derecha));
+    __m256 ny = _mm256_add_ps(y, desplazamiento(dir, vel, Arriba, Abajo));
+    __m256i col = redondear(nx), fila = redondear(ny);
+
+    // Paso: un bit por casilla en palabras de 32 (la mitad baja de cada
+    // palabra de 64 va primero). Fuera del tablero se consulta la casilla 0.
+    const __m256i lado = _mm256_set1_epi32(paso.ladoTablero());
+    __m256i sale = _mm256_or_si256(fuera(col, lado), fuera(fila, lado));
+    __m256i colC = _mm256_andnot_si256(sale, col), filaC = _mm256_andnot_si256(sale, fila);
+    __m256i idx = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(tipo, _mm256_set1_epi32(static_cast<int>(2 * paso.palabrasPlano()))),
+                         _mm256_mullo_epi32(filaC, _mm256_set1_epi32(2 * paso.palabrasPorFila()))),
+        _mm256_srli_epi32(colC, 5));
+    __m256i palabra = _mm256_i32gather_epi32(reinterpret_cast<const int*>(paso.datos()), idx, 4);
+    __m256i bloq = _mm256_and_si256(_mm256_srlv_epi32(palabra, _mm256_and_si256(colC, _mm256_set1_epi32(31))), uno);
+    bloq = _mm256_or_si256(_mm256_cmpeq_epi32(bloq, uno), sale);
+
+    __m256i rapido = _mm256_andnot_si256(_mm256_or_si256(agotado, bloq), vivo);
+    __m256 rapidoF = _mm256_castsi256_ps(rapido);
+    _mm256_storeu_ps(&h.x[i], _mm256_blendv_ps(x, nx, rapidoF));
+    _mm256_storeu_ps(&h.y[i], _mm256_blendv_ps(y, ny, rapidoF));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&h.ticksParaCambiar[i]), _mm256_add_epi32(ticks, rapido));
+
+    __m256i colAnt = redondear(x), filaAnt = redondear(y);
+    __m256i quieto = _mm256_and_si256(_mm256_cmpeq_epi32(col, colAnt), _mm256_cmpeq_epi32(fila, filaAnt));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.colAnt), colAnt);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.filaAnt), filaAnt);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.col), col);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.fila), fila);
+    cambian = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(quieto, rapido))));
+    resto = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(rapido, vivo))));
+}
+
+inline int LogicaHorda::primeroEnCelda(const HordaEnemigos& h, int num, int fila, int col) {
+    using namespace horda_detalle;
+    const __m256i f = _mm256_set1_epi32(fila), c = _mm256_set1_epi32(col), uno = _mm256_set1_epi32(1);
+    for (int i = 0; i < num; i += ANCHO) {
+        __m256i enCelda = _mm256_and_si256(_mm256_cmpeq_epi32(redondear(_mm256_loadu_ps(&h.y[i])), f),
+                                           _mm256_cmpeq_epi32(redondear(_mm256_loadu_ps(&h.x[i])), c));
+        __m256i vivo = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h.vivo[i])), uno);
+        unsigned m = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(enCelda, vivo))));
+        if (m) return i + bitMenor(m);
+    }
+    return -1;
+}
+
+#elif defined(NUCLEO_HORDA_SSE2)
+
+namespace horda_detalle {
+// Sin blendv ni min/max de enteros: se combina con máscaras
+inline __m128 elegir(__m128 m, __m128 si, __m128 no) { return _mm_or_ps(_mm_and_ps(m, si), _mm_andnot_ps(m, no)); }
+// std::round (mitad lejos del cero) a entero: truncar y corregir con la parte
+// fraccionaria, que es exacta en float
+inline __m128i redondear(__m128 v) {
+    __m128i t = _mm_cvttps_epi32(v);
+    __m128 f = _mm_sub_ps(v, _mm_cvtepi32_ps(t));
+    __m128i arriba = _mm_castps_si128(_mm_cmpge_ps(f, _mm_set1_ps(0.5f)));
+    __m128i abajo = _mm_castps_si128(_mm_cmple_ps(f, _mm_set1_ps(-0.5f)));
+    return _mm_add_epi32(_mm_sub_epi32(t, arriba), abajo);
+}
+inline __m128 desplazamiento(__m128i dir, __m128 vel, int menos, int mas) {
+    __m128 m = _mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, _mm_set1_epi32(mas))), vel);
+    __m128 n = _mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, _mm_set1_epi32(menos))), vel);
+    return _mm_sub_ps(m, n);
+}
+inline __m128i fuera(__m128i v, __m128i lado) {
+    return _mm_or_si128(_mm_cmplt_epi32(v, _mm_setzero_si128()),
+                        _mm_cmpgt_epi32(v, _mm_sub_epi32(lado, _mm_set1_epi32(1))));
+}
+} // namespace horda_detalle
+
+inline void LogicaHorda::pasoBloque(HordaEnemigos& h, int i, const PasoHorda& paso, CeldasBloque& c,
+                                    unsigned& cambian, unsigned& resto) {
+    using namespace horda_detalle;
+    const __m128i uno = _mm_set1_epi32(1);
+    __m128 x = _mm_loadu_ps(&h.x[i]), y = _mm_loadu_ps(&h.y[i]);
+    __m128 vel = _mm_loadu_ps(&h.velocidad[i]);
+    __m128i dir = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&h.dir[i]));
+    __m128i vivo = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h.vivo[i])), uno);
+    __m128i ticks = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&h.ticksParaCambiar[i]));
+
+    // Le toca elegir dirección si el contador llega a cero tras descontar este tick
+    __m128i agotado = _mm_cmplt_epi32(_mm_sub_epi32(ticks, uno), uno);
+    __m128 nx = _mm_add_ps(x, desplazamiento(dir, vel, Izquierda, Derecha));
+    __m128 ny = _mm_add_ps(y, desplazamiento(dir, vel, Arriba, Abajo));
+    __m128i col = redondear(nx), fila = redondear(ny);
+    const __m128i lado = _mm_set1_epi32(paso.ladoTablero());
+    __m128i sale = _mm_or_si128(fuera(col, lado), fuera(fila, lado));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c.col), col);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c.fila), fila);
+
+    // SSE2 no tiene gather: la consulta del paso va carril a carril
+    alignas(16) int32_t bloq[ANCHO];
+    for (int k = 0; k < ANCHO; k++) {
+        bool dentro = c.fila[k] >= 0 && c.fila[k] < paso.ladoTablero() && c.col[k] >= 0 &&
+                      c.col[k] < paso.ladoTablero();
+        bloq[k] = (dentro && paso.bloqueada(h.tipo[i + k], c.fila[k], c.col[k])) ? -1 : 0;
+    }
+    __m128i noPasa = _mm_or_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(bloq)), sale);
+
+    __m128i rapido = _mm_andnot_si128(_mm_or_si128(agotado, noPasa), vivo);
+    __m128 rapidoF = _mm_castsi128_ps(rapido);
+    _mm_storeu_ps(&h.x[i], elegir(rapidoF, nx, x));
+    _mm_storeu_ps(&h.y[i], elegir(rapidoF, ny, y));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h.ticksParaCambiar[i]), _mm_add_epi32(ticks, rapido));
+
+    __m128i colAnt = redondear(x), filaAnt = redondear(y);
+    __m128i quieto = _mm_and_si128(_mm_cmpeq_epi32(col, colAnt), _mm_cmpeq_epi32(fila, filaAnt));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c.colAnt), colAnt);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c.filaAnt), filaAnt);
+    cambian = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(quieto, rapido))));
+    resto = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(rapido, vivo))));
+}
+
+inline int LogicaHorda::primeroEnCelda(const HordaEnemigos& h, int num, int fila, int col) {
+    using namespace horda_detalle;
+    const __m128i f = _mm_set1_epi32(fila), c = _mm_set1_epi32(col), uno = _mm_set1_epi32(1);
+    for (int i = 0; i < num; i += ANCHO) {
+        __m128i enCelda = _mm_and_si128(_mm_cmpeq_epi32(redondear(_mm_loadu_ps(&h.y[i])), f),
+                                        _mm_cmpeq_epi32(redondear(_mm_loadu_ps(&h.x[i])), c));
+        __m128i vivo = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h.vivo[i])), uno);
+        unsigned m = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(enCelda, vivo))));
+        if (m) return i + bitMenor(m);
+    }
+    return -1;
+}
+
+#else
+
+inline void LogicaHorda::pasoBloque(HordaEnemigos& h, int i, const PasoHorda& paso, CeldasBloque& c,
+                                    unsigned& cambian, unsigned& resto) {
+    cambian = resto = 0;
+    if (!h.vivo[i]) return;
+    Posicion ant(h.x[i], h.y[i]), pos = ant;
+    switch (h.dir[i]) {
+        case Arriba:    pos.y -= h.velocidad[i]; break;
+        case Abajo:     pos.y += h.velocidad[i]; break;
+        case Izquierda: pos.x -= h.velocidad[i]; break;
+        case Derecha:   pos.x += h.velocidad[i]; break;
+        default: break;
+    }
+    int fila = pos.celdaY(), col = pos.celdaX();
+    const int lado = paso.ladoTablero();
+    bool pasa = fila >= 0 && fila < lado && col >= 0 && col < lado && !paso.bloqueada(h.tipo[i], fila, col);
+    if (h.ticksParaCambiar[i] - 1 <= 0 || !pasa) {
+        resto = 1;
+        return;
+    }
+    h.x[i] = pos.x;
+    h.y[i] = pos.y;
+    h.ticksParaCambiar[i]--;
+    c.filaAnt[0] = ant.celdaY();
+    c.colAnt[0] = ant.celdaX();
+    c.fila[0] = fila;
+    c.col[0] = col;
+    cambian = (fila != c.filaAnt[0] || col != c.colAnt[0]) ? 1 : 0;
+}
+
+inline int LogicaHorda::primeroEnCelda(const HordaEnemigos& h, int num, int fila, int col) {
+    for (int i = 0; i < num; i++)
+        if (h.vivo[i] && Posicion(h.x[i], h.y[i]).celdaY() == fila && Posicion(h.x[i], h.y[i]).celdaX() == col)
+            return i;
+    return -1;
+}
+
+#endif
+
+#endif // NUCLEO_HORDA_H
@@ -0,0 +1,183 @@
+#include "Juego.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+template <class Cfg>
+void JuegoT<Cfg>::tickBot() {
+    if (!esBot || estado != Jugando || !jugador.vivo) return;
+    // El bot da un paso (una casilla) cada vez que su velocidad completa una
+    avanceBot += jugador.velocidad / ticksPorSegundo;
+    if (avanceBot < 1) return;
+    avanceBot -= 1;
+
+    Posicion ant = jugador.pos;
+    int jr = ant.celdaY();
+    int jc = ant.celdaX();
+    // La ruta sale del campo de distancias a las frutas: se repara cuando el
+    // hielo o las frutas cambian y solo se recalcula al empezar el nivel
+    Direccion paso = Ninguna;
+    if (pasosBloqueadoBot < 2) {
+        campoBot.actualizarHaciaFrutas(mapa);
+        paso = campoBot.siguientePaso(jr, jc);
+    }
+    if (paso != Ninguna) {
+        moverJugador(paso);
+        ultimaDirBot = paso;
+    } else {
+        // Sin fruta alcanzable (o atascado): paso al azar
+        Direccion dirs[4] = {Arriba, Abajo, Izquierda, Derecha};
+        for (int k = 0; k < 4; ++k) {
+            int r = rng.acotado(4);
+            std::swap(dirs[k], dirs[r]);
+        }
+        for (Direccion d : dirs) {
+            int nr = jr, nc = jc;
+            switch (d) {
+                case Arriba:    nr--; break;
+                case Abajo:     nr++; break;
+                case Izquierda: nc--; break;
+                case Derecha:   nc++; break;
+                default: break;
+            }
+            if (nr < 0 || nr >= cfg.tam() || nc < 0 || nc >= cfg.tam()) continue;
+            if (!mapa.pasableNormal(nr, nc)) continue;
+            moverJugador(d);
+            ultimaDirBot = d;
+            break;
+        }
+    }
+
+    if (jugador.pos.celdaY() == jr && jugador.pos.celdaX() == jc) {
+        pasosBloqueadoBot++;
+        if (pasosBloqueadoBot > 6) pasosBloqueadoBot = 6;
+    } else {
+        pasosBloqueadoBot = 0;
+    }
+}
+
+template <class Cfg>
+void JuegoT<Cfg>::reiniciarNivel(int n, uint64_t semillaNivel) {
+    semilla = semillaNivel;
+    rng.sembrar(semilla);
+    nivel = n;
+    estado = Jugando;
+    jugador.vivo = true;
+    jugador.dir = Ninguna;
+    jugador.frutas_recogidas = 0;
+    ticksDesdeInicio = 0;
+    pasosBloqueadoBot = 0;
+    avanceBot = 0;
+    ultimaDirBot = Ninguna;
+    enemigoAsesino = -1;
+    mapa.inicializar();
+    ocupacion.limpiar();
+    numEnemigos = cfg.enemigosNivel(nivel);
+    dimensionar(enemigos, numEnemigos);
+    frutas.vaciar();
+}
+
+template <class Cfg>
+void JuegoT<Cfg>::ponerEnemigo(int i, int fila, int col, int ticksParaCambiar) {
+    Enemigo e(static_cast<float>(col), static_cast<float>(fila),
+              (i == numEnemigos - 1 && nivel >= 3) ? Especial : Normal, ticksPorSegundo);
+    e.ticksParaCambiar = ticksParaCambiar;
+    if constexpr (enHorda<Cfg>) enemigos.fijar(i, e);
+    else enemigos[i] = e;
+    ocupacion.entraEnemigo(fila, col);
+}
+
+template <class Cfg>
+void JuegoT<Cfg>::cerrarNivel() {
+    for (int i = 0; i < frutas.tamano(); i++)
+        ocupacion.ponerFruta(frutas[i].pos.celdaY(), frutas[i].pos.celdaX(), i);
+    uvasRestantes = frutas.tamano();
+    platanosRestantes = 0;
+    const int tam = cfg.tam();
+    quadTreeEnemigos.reiniciar(0.0, 0.0, static_cast<double>(tam), static_cast<double>(tam));
+}
+
+template <class Cfg>
+void JuegoT<Cfg>::iniciarNivel(int n, uint64_t semillaNivel) {
+    reiniciarNivel(n, semillaNivel);
+    const int tam = cfg.tam();
+    // El generador deja libre el centro y conectado con todo lo demás
+    const int pr = tam / 2, pc = tam / 2;
+    mapa.ponerMurosAleatorios(rng, pr, pc);
+    jugador.pos = Posicion(static_cast<float>(pc), static_cast<float>(pr));
+    // Franja de aparición: filas altas del mapa (1..3 en el clásico), lejos
+    // del jugador central. Cada enemigo se sortea entre las casillas vacías de
+    // la franja que siguen sin enemigo.
+    const int franja = std::min(std::max(3, tam / 5), tam - 2);
+    CasillasLibres<celdasTablero(Cfg::TAM)>& libres = casillasLibres;
+    libres.reiniciar(tam * tam);
+    for (int er = 1; er <= franja; er++)
+        mapa.paraVaciasEnFila(er, 1, tam - 1, [&](int ec) {
+            if (std::abs(er - pr) + std::abs(ec - pc) > 2) libres.agregar(er * tam + ec);
+        });
+    for (int i = 0; i < numEnemigos; i++) {
+        int er, ec;
+        if (!libres.vacio()) {
+            int k = libres.sortear(rng);
+            libres.quitar(k);
+            er = k / tam;
+            ec = k % tam;
+        } else {
+            // Franja llena: se amontonan donde caigan
+            er = 1 + rng.acotado(franja);
+            ec = 1 + rng.acotado(tam - 2);
+        }
+        ponerEnemigo(i, er, ec, rng.acotado(10));
+    }
+
+    int cantUvas = cfg.uvasNivel(nivel);
+    frutas.reservar(cantUvas);
+    mapa.ponerFrutas(frutas, Uva, cantUvas, rng, casillasLibres);
+    cerrarNivel();
+}
+
+template <class Cfg>
+void JuegoT<Cfg>::actualizar() {
+    if (estado != Jugando) return;
+    ticksDesdeInicio++;
+    if (esBot) tickBot();
+    int jx = jugador.pos.celdaX(), jy = jugador.pos.celdaY();
+    bool atrapado = false;
+    if constexpr (enHorda<Cfg>) {
+        LogicaHorda::actualizar(enemigos, numEnemigos, jugador, mapa, ocupacion, campoNormal, campoEspecial,
+                                pasoHorda, rng);
+        // La ocupación ya cuenta los enemigos de cada casilla: solo si hay
+        // alguno en la del jugador se busca cuál fue
+        atrapado = ticksDesdeInicio > 1 && ocupacion.enemigosEn(jy, jx) > 0;
+        if (atrapado && jugador.vivo && enemigoAsesino < 0)
+            enemigoAsesino = LogicaHorda::primeroEnCelda(enemigos, numEnemigos, jy, jx);
+    } else {
+        for (int i = 0; i < numEnemigos; i++) {
+            if (!enemigos[i].vivo) continue;
+            CampoDistancias<Cfg>& campo = (enemigos[i].tipo == Especial) ? campoEspecial : campoNormal;
+            LogicaEnemigo::actualizar(enemigos[i], jugador, mapa, ocupacion, campo, rng);
+        }
+        quadTreeEnemigos.limpiar();
+        for (int i = 0; i < numEnemigos; i++) {
+            if (!enemigos[i].vivo) continue;
+            double ex = enemigos[i].pos.celdaX() + 0.5, ey = enemigos[i].pos.celdaY() + 0.5;
+            quadTreeEnemigos.insertar(ex, ey);
+        }
+        atrapado = ticksDesdeInicio > 1 &&
+                   quadTreeEnemigos.hayPuntosEnCelda(static_cast<double>(jx), static_cast<double>(jy));
+        if (atrapado)
+            for (int i = 0; i < numEnemigos && enemigoAsesino < 0; i++)
+                if (LogicaEnemigo::colisionConJugador(enemigos[i], jugador)) enemigoAsesino = i;
+    }
+    if (atrapado) {
+        jugador.vivo = false;
+        estado = Perdiste;
+        return;
+    }
+    verFrutas();
+    verSiGano();
+}
+
+template class JuegoT<ConfigClasica>;
+template class JuegoT<ConfigDinamica>;
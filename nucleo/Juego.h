@@ -0,0 +1,219 @@
+#ifndef NUCLEO_JUEGO_H
+#define NUCLEO_JUEGO_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Aleatorio.h"
+#include "CampoDistancias.h"
+#include "CasillasLibres.h"
+#include "Config.h"
+#include "CongelarDescongelar.h"
+#include "EntidadesVivas.h"
+#include "Horda.h"
+#include "LogicaEnemigo.h"
+#include "Ocupacion.h"
+#include "QuadTree.h"
+
+enum EstadoJuego { Menu, Jugando, Ganaste, Perdiste };
+
+// Acción del jugador que llega de fuera del tick (teclado, otro hilo, red)
+enum TipoOrden { OrdenMover, OrdenCongelar, OrdenDescongelar };
+struct Orden {
+    TipoOrden tipo = OrdenMover;
+    Direccion dir = Ninguna; // solo para OrdenMover
+};
+
+// Código de 3 bits de una orden, el que usan las repeticiones y la red: la
+// Direccion (0-4) para mover, 5 congelar y 6 descongelar
+constexpr int BITS_CODIGO_ORDEN = 3;
+inline uint32_t codigoOrden(const Orden& o) {
+    switch (o.tipo) {
+        case OrdenCongelar: return 5;
+        case OrdenDescongelar: return 6;
+        case OrdenMover: break;
+    }
+    return static_cast<uint32_t>(o.dir);
+}
+inline bool ordenDeCodigo(uint32_t codigo, Orden& o) {
+    if (codigo == 5) o = {OrdenCongelar, Ninguna};
+    else if (codigo == 6) o = {OrdenDescongelar, Ninguna};
+    else if (codigo <= Ninguna) o = {OrdenMover, static_cast<Direccion>(codigo)};
+    else return false;
+    return true;
+}
+
+// Todo el estado de una partida que no se puede volver a calcular: mapa,
+// entidades, generador y contadores (más la ocupación, que es barata de
+// copiar). Con una Cfg fija no tiene punteros ni memoria propia, así que es
+// trivialmente copiable: guardar o restaurar una partida es copiar este
+// bloque de bytes (ver JuegoT::guardar/restaurar y Guardado.h).
+template <class Cfg>
+struct DatosPartidaT {
+    Cfg cfg;
+    EstadoJuego estado = Menu;
+    int nivel = 1;
+    Jugador jugador;
+    bool esBot = false;
+    MapaT<Cfg> mapa{cfg};
+    AlmacenEnemigos<Cfg> enemigos{}; // por campos en los tableros de lado variable (ver Horda.h)
+    int numEnemigos = 0;
+    // Solo las que quedan por recoger: al recogerla, la última pasa a su puesto
+    EntidadesVivas<Fruta, Cfg::MAX_FRUTAS> frutas{};
+    int uvasRestantes = 0;
+    int platanosRestantes = 0;
+    OcupacionT<Cfg> ocupacion{cfg}; // celda -> fruta / enemigos, para consultas O(1)
+    int ticksDesdeInicio = 0;
+    // Pasos de actualizar() por segundo de juego; se aplica al iniciar nivel
+    int ticksPorSegundo = TICKS_POR_SEGUNDO;
+    float avanceBot = 0; // fracción de casilla que el bot lleva acumulada
+    Direccion ultimaDirBot = Ninguna;
+    int pasosBloqueadoBot = 0;
+    int enemigoAsesino = -1; // índice del enemigo que atrapó al jugador (-1 si sigue vivo)
+    // Cada partida tiene su propio generador; la semilla del nivel actual queda
+    // registrada para poder repetirlo tick a tick.
+    Aleatorio rng;
+    uint64_t semilla = 0;
+
+    DatosPartidaT() = default;
+    explicit DatosPartidaT(const Cfg& c) : cfg(c) {}
+};
+
+using DatosPartida = DatosPartidaT<ConfigClasica>;
+static_assert(std::is_trivially_copyable<DatosPartida>::value,
+              "El estado del tablero clásico debe poder copiarse byte a byte");
+
+// Simulación completa de una partida. No depende de la interfaz: WidgetTablero
+// la dibuja y el simulador headless la avanza con actualizar() sin temporizador.
+// Cfg fija el tamaño del tablero y los topes de entidades (ver Config.h); las
+// dos variantes se instancian en Juego.cpp.
+//
+// El estado está en la base DatosPartidaT; aquí quedan solo las estructuras
+// que se derivan de él (campos de distancias y quadtree), que se rehacen solas.
+template <class Cfg>
+class JuegoT : public DatosPartidaT<Cfg> {
+    using Datos = DatosPartidaT<Cfg>;
+
+public:
+    // La base depende de Cfg: sin esto cada uso necesitaría this->
+    using Datos::cfg;
+    using Datos::estado;
+    using Datos::nivel;
+    using Datos::jugador;
+    using Datos::esBot;
+    using Datos::mapa;
+    using Datos::enemigos;
+    using Datos::numEnemigos;
+    using Datos::frutas;
+    using Datos::uvasRestantes;
+    using Datos::platanosRestantes;
+    using Datos::ocupacion;
+    using Datos::ticksDesdeInicio;
+    using Datos::ticksPorSegundo;
+    using Datos::avanceBot;
+    using Datos::ultimaDirBot;
+    using Datos::pasosBloqueadoBot;
+    using Datos::enemigoAsesino;
+    using Datos::rng;
+    using Datos::semilla;
+
+    // Distancias al jugador para cada tipo de enemigo, compartidas por todos
+    CampoDistancias<Cfg> campoNormal{PasoNormal, cfg};
+    CampoDistancias<Cfg> campoEspecial{PasoEspecial, cfg};
+    // Ruta del bot: distancias a la fruta recogible más cercana
+    CampoDistancias<Cfg> campoBot{PasoJugador, cfg};
+    // Choque de los enemigos con el jugador; la horda usa primeroEnCelda()
+    QuadTree quadTreeEnemigos{0.0, 0.0, static_cast<double>(cfg.tam()), static_cast<double>(cfg.tam())};
+    // Memoria de trabajo de iniciarNivel: dónde aún cabe un enemigo o una fruta
+    CasillasLibres<celdasTablero(Cfg::TAM)> casillasLibres;
+    // Casillas vedadas a cada tipo de enemigo, para los núcleos de la horda
+    PasoHorda pasoHorda;
+
+    JuegoT() = default;
+    explicit JuegoT(const Cfg& c) : Datos(c) {}
+
+    // Foto del estado para volver a él con restaurar(); se copia por valor
+    const Datos& guardar() const { return *this; }
+    // Por asignación y no con memcpy sobre la base: el compilador puede haber
+    // colocado miembros de JuegoT en el relleno final de Datos. Los campos de
+    // distancias y el paso de la horda se rehacen en la siguiente consulta; el
+    // quadtree ya se reconstruye en cada tick.
+    void restaurar(const Datos& d) {
+        static_cast<Datos&>(*this) = d;
+        campoNormal.invalidar();
+        campoEspecial.invalidar();
+        campoBot.invalidar();
+        pasoHorda.invalidar();
+    }
+
+    void tickBot();
+    void iniciarNivel(int n, uint64_t semillaNivel);
+    // Piezas de iniciarNivel, también para empezar niveles ya generados (ver
+    // PaqueteNiveles.h): contadores a cero, generador sembrado y mapa vacío;
+    // cada enemigo en su casilla; y, con las frutas puestas, su ocupación y
+    // el quadtree
+    void reiniciarNivel(int n, uint64_t semillaNivel);
+    void ponerEnemigo(int i, int fila, int col, int ticksParaCambiar);
+    void cerrarNivel();
+    // Sin semilla explícita, la siguiente sale del propio generador de la partida
+    void iniciarNivel(int n) { iniciarNivel(n, rng.siguiente()); }
+
+    bool ocupadoPorOtroEnemigo(int c, int r, int excepto) const {
+        int n = ocupacion.enemigosEn(r, c);
+        if (excepto >= 0 && excepto < numEnemigos && enemigos[excepto].vivo &&
+            enemigos[excepto].pos.celdaX() == c && enemigos[excepto].pos.celdaY() == r)
+            n--;
+        return n > 0;
+    }
+
+    bool hayFrutaCongeladaEn(int fila, int col) const {
+        return mapa.hayFrutaCongelada(fila, col);
+    }
+
+    void moverJugador(Direccion d) {
+        if (estado != Jugando || !jugador.vivo) return;
+        Posicion ant = jugador.pos;
+        jugador.mover(d);
+        int fr = jugador.pos.celdaY(), fc = jugador.pos.celdaX();
+        if (!mapa.pasableJugador(fr, fc)) jugador.pos = ant;
+    }
+
+    void verFrutas() {
+        int pr = jugador.pos.celdaY(), pc = jugador.pos.celdaX();
+        int i = ocupacion.frutaEn(pr, pc);
+        if (i == OcupacionT<Cfg>::SIN_FRUTA || frutas[i].congelada) return;
+        ocupacion.quitarFruta(pr, pc);
+        mapa.recogerFruta(pr, pc);
+        jugador.frutas_recogidas++;
+        if (frutas[i].tipoFruta == Uva) uvasRestantes--;
+        else if (frutas[i].tipoFruta == Platano) platanosRestantes--;
+        frutas.quitar(i);
+        if (i < frutas.tamano()) ocupacion.ponerFruta(frutas[i].pos.celdaY(), frutas[i].pos.celdaX(), i);
+    }
+
+    void verSiGano() {
+        if (!mapa.quedanFrutas()) estado = Ganaste;
+    }
+
+    void actualizar();
+
+    void congelar() { CongelarDescongelar::congelar(jugador, mapa, ocupacion, frutas.data()); }
+    void descongelar() { CongelarDescongelar::descongelar(jugador, mapa, ocupacion, frutas.data()); }
+
+    void aplicar(const Orden& o) {
+        switch (o.tipo) {
+            case OrdenMover: moverJugador(o.dir); break;
+            case OrdenCongelar: congelar(); break;
+            case OrdenDescongelar: descongelar(); break;
+        }
+    }
+};
+
+// El juego de siempre (15x15) y la variante de tamaño elegido al ejecutar
+using Juego = JuegoT<ConfigClasica>;
+using JuegoDinamico = JuegoT<ConfigDinamica>;
+
+extern template class JuegoT<ConfigClasica>;
+extern template class JuegoT<ConfigDinamica>;
+
+#endif // NUCLEO_JUEGO_H
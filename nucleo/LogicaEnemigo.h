@@ -0,0 +1,63 @@
+#ifndef NUCLEO_LOGICAENEMIGO_H
+#define NUCLEO_LOGICAENEMIGO_H
+
+#include "CampoDistancias.h"
+#include "Mapa.h"
+#include "Ocupacion.h"
+
+class LogicaEnemigo {
+public:
+    template <class Cfg>
+    static bool hayFrutaCongeladaEn(int fila, int col, const MapaT<Cfg>& mapa) {
+        return mapa.hayFrutaCongelada(fila, col);
+    }
+
+    template <class Cfg>
+    static bool puedePasarCelda(int fila, int col, const Enemigo& e, const MapaT<Cfg>& mapa) {
+        return (e.tipo == Especial) ? mapa.pasableEspecial(fila, col) : mapa.pasableNormal(fila, col);
+    }
+
+    // Sigue el campo de distancias de su tipo (compartido por todos los enemigos
+    // de ese tipo); si no hay camino hasta el jugador, dirección al azar
+    template <class Cfg>
+    static void elegirDireccionHaciaJugador(Enemigo& e, const Jugador& jug, const MapaT<Cfg>& mapa,
+                                            CampoDistancias<Cfg>& campo, Aleatorio& rng) {
+        campo.actualizar(mapa, jug.pos.celdaY(), jug.pos.celdaX());
+        Direccion d = campo.siguientePaso(e.pos.celdaY(), e.pos.celdaX());
+        e.dir = (d != Ninguna) ? d : static_cast<Direccion>(rng.acotado(4));
+    }
+
+    template <class Cfg>
+    static void actualizar(Enemigo& e, const Jugador& jug, MapaT<Cfg>& mapa, OcupacionT<Cfg>& ocupacion,
+                           CampoDistancias<Cfg>& campo, Aleatorio& rng) {
+        if (!e.vivo) return;
+        e.ticksParaCambiar--;
+        if (e.ticksParaCambiar <= 0) {
+            e.ticksParaCambiar = 5 + rng.acotado(15);
+            if (rng.real() < PROB_PERSECUCION)
+                elegirDireccionHaciaJugador(e, jug, mapa, campo, rng);
+            else {
+                int d = rng.acotado(4);
+                e.dir = static_cast<Direccion>(d);
+            }
+        }
+        Posicion ant = e.pos;
+        e.mover();
+        int nr = e.pos.celdaY(), nc = e.pos.celdaX();
+        bool pasar = puedePasarCelda(nr, nc, e, mapa);
+        if (!pasar) {
+            e.pos = ant;
+            int d = rng.acotado(4);
+            e.dir = static_cast<Direccion>(d);
+        } else {
+            ocupacion.moverEnemigo(ant.celdaY(), ant.celdaX(), nr, nc);
+        }
+    }
+
+    static bool colisionConJugador(const Enemigo& e, const Jugador& jug) {
+        if (!jug.vivo) return false;
+        return e.pos.celdaX() == jug.pos.celdaX() && e.pos.celdaY() == jug.pos.celdaY();
+    }
+};
+
+#endif // NUCLEO_LOGICAENEMIGO_H
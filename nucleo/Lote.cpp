@@ -0,0 +1,73 @@
+#include "Lote.h"
+
+#include <algorithm>
+
+#include "Juego.h"
+
+void EstadisticasNivel::acumular(const EstadisticasNivel& o) {
+    partidas += o.partidas;
+    ganadas += o.ganadas;
+    muertesNormal += o.muertesNormal;
+    muertesEspecial += o.muertesEspecial;
+    agotadas += o.agotadas;
+    ticksTotales += o.ticksTotales;
+    sumaTicksVictoria += o.sumaTicksVictoria;
+    minTicksVictoria = std::min(minTicksVictoria, o.minTicksVictoria);
+    maxTicksVictoria = std::max(maxTicksVictoria, o.maxTicksVictoria);
+}
+
+uint64_t semillaPartida(uint64_t base, int nivel, int indice) {
+    uint64_t z = base ^ (static_cast<uint64_t>(nivel) << 40) ^ static_cast<uint64_t>(indice);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::vector<EstadisticasNivel> ejecutarLote(const ConfigLote& cfg, PoolTrabajo& pool) {
+    int numNiveles = std::max(0, cfg.nivelMax - cfg.nivelMin + 1);
+    int porTarea = std::max(1, cfg.partidasPorTarea);
+    int tareasPorNivel = (cfg.partidasPorNivel + porTarea - 1) / porTarea;
+
+    // Un acumulador por hilo (bloques separados en el heap) para no compartir
+    // líneas de caché; se suman al final
+    std::vector<std::vector<EstadisticasNivel>> porHilo(pool.numHilos(),
+                                                        std::vector<EstadisticasNivel>(numNiveles));
+
+    pool.paraCada(numNiveles * tareasPorNivel, [&](int tarea, int hilo) {
+        int idxNivel = tarea / tareasPorNivel;
+        int nivel = cfg.nivelMin + idxNivel;
+        int desde = (tarea % tareasPorNivel) * porTarea;
+        int hasta = std::min(desde + porTarea, cfg.partidasPorNivel);
+        EstadisticasNivel& est = porHilo[hilo][idxNivel];
+
+        Juego juego;
+        juego.esBot = true;
+        for (int p = desde; p < hasta; p++) {
+            juego.iniciarNivel(nivel, semillaPartida(cfg.semillaBase, nivel, p));
+            while (juego.estado == Jugando && juego.ticksDesdeInicio < cfg.maxTicks)
+                juego.actualizar();
+            est.partidas++;
+            est.ticksTotales += juego.ticksDesdeInicio;
+            if (juego.estado == Ganaste) {
+                est.ganadas++;
+                est.sumaTicksVictoria += juego.ticksDesdeInicio;
+                est.minTicksVictoria = std::min(est.minTicksVictoria, juego.ticksDesdeInicio);
+                est.maxTicksVictoria = std::max(est.maxTicksVictoria, juego.ticksDesdeInicio);
+            } else if (juego.estado == Perdiste) {
+                if (juego.enemigoAsesino >= 0 && juego.enemigos[juego.enemigoAsesino].tipo == Especial)
+                    est.muertesEspecial++;
+                else
+                    est.muertesNormal++;
+            } else {
+                est.agotadas++;
+            }
+        }
+    });
+
+    std::vector<EstadisticasNivel> total(numNiveles);
+    for (int i = 0; i < numNiveles; i++) {
+        total[i].nivel = cfg.nivelMin + i;
+        for (const auto& h : porHilo) total[i].acumular(h[i]);
+    }
+    return total;
+}
@@ -0,0 +1,45 @@
+#ifndef NUCLEO_LOTE_H
+#define NUCLEO_LOTE_H
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "PoolTrabajo.h"
+
+// Resultados agregados de muchas partidas del bot en un mismo nivel
+struct EstadisticasNivel {
+    int nivel = 0;
+    long long partidas = 0;
+    long long ganadas = 0;
+    long long muertesNormal = 0;    // atrapado por un enemigo Normal
+    long long muertesEspecial = 0;  // atrapado por el enemigo Especial
+    long long agotadas = 0;         // alcanzó el máximo de ticks sin terminar
+    long long ticksTotales = 0;
+    long long sumaTicksVictoria = 0;
+    int minTicksVictoria = INT_MAX;
+    int maxTicksVictoria = 0;
+
+    double tasaVictoria() const { return partidas ? static_cast<double>(ganadas) / partidas : 0.0; }
+    double ticksMediosVictoria() const { return ganadas ? static_cast<double>(sumaTicksVictoria) / ganadas : 0.0; }
+    void acumular(const EstadisticasNivel& o);
+};
+
+struct ConfigLote {
+    int nivelMin = 1;
+    int nivelMax = 6;
+    int partidasPorNivel = 1000;
+    uint64_t semillaBase = 1;
+    int maxTicks = 5000;
+    // Partidas consecutivas del mismo nivel que forman una tarea del pool
+    int partidasPorTarea = 16;
+};
+
+// Semilla de la partida 'indice' del nivel: depende solo de los parámetros, no
+// del hilo que la ejecute, así que el lote da los mismos totales con 1 o N hilos.
+uint64_t semillaPartida(uint64_t base, int nivel, int indice);
+
+// Reparte todas las partidas del lote en el pool y devuelve una entrada por nivel
+std::vector<EstadisticasNivel> ejecutarLote(const ConfigLote& cfg, PoolTrabajo& pool);
+
+#endif // NUCLEO_LOTE_H
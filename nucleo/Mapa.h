@@ -0,0 +1,407 @@
+#ifndef NUCLEO_MAPA_H
+#define NUCLEO_MAPA_H
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+#include "Aleatorio.h"
+#include "Bitboard.h"
+#include "CasillasLibres.h"
+#include "Config.h"
+#include "ConjuntosDisjuntos.h"
+#include "Entidades.h"
+#include "EntidadesVivas.h"
+
+// Tablero en bitboards: un plano de bits por tipo de casilla más uno de frutas
+// vivas (sin recoger) y otro de frutas congeladas. Las consultas de paso, los
+// rayos de hielo y la condición de victoria son operaciones de máscara sobre
+// unas pocas palabras; obtenerCelda() reconstruye el TipoCelda de siempre para
+// quien lo necesite (la interfaz, por ejemplo).
+//
+// Cfg fija el lado del tablero (ver Config.h): ConfigClasica para el 15x15 de
+// siempre, ConfigDinamica para mapas grandes.
+//
+// Las casillas que cambian durante la partida (hielo, fruta congelada o
+// recogida) quedan anotadas en un registro circular, para que quien derive
+// datos del mapa (los campos de distancias) pueda repararlos en lugar de
+// recalcularlos. Los cambios masivos (nuevo nivel) suben generacion().
+// Qué casillas puede pisar quien recorre el tablero (ver pasable)
+enum ReglaPaso { PasoNormal, PasoEspecial, PasoJugador };
+
+inline ReglaPaso reglaEnemigo(TipoEnemigo t) { return t == Especial ? PasoEspecial : PasoNormal; }
+
+template <class Cfg>
+class MapaT {
+    using Plano = PlanoBits<Cfg::TAM>;
+
+    Cfg cfg;
+    // planos[t]: casillas cuyo tipo es t (Vacia no tiene plano: es la ausencia de todos)
+    Plano planos[FrutaCongelada + 1];
+    Plano conFruta;  // unión de los planos de fruta; fija desde ponerFrutas
+    Plano frutaViva;
+    Plano congelada;
+
+    struct CambioCelda {
+        uint16_t fila, col;
+    };
+    static constexpr int CAPACIDAD_CAMBIOS = 64;
+    CambioCelda cambios[CAPACIDAD_CAMBIOS] = {};
+    uint64_t numCambios = 0;
+    uint32_t generacionMapa = 0;
+
+    void anotarCambio(int fila, int col) {
+        cambios[numCambios++ % CAPACIDAD_CAMBIOS] = {static_cast<uint16_t>(fila), static_cast<uint16_t>(col)};
+    }
+    // Anota las casillas de 'm' en el bloque k de una línea
+    void anotarBloque(bool horizontal, int idx, int k, uint64_t m) {
+        for (; m; m &= m - 1) {
+            int pos = k * 64 + bitMenor(m);
+            if (horizontal) anotarCambio(idx, pos); else anotarCambio(pos, idx);
+        }
+    }
+
+    bool dentro(int fila, int col) const {
+        return fila >= 0 && fila < tam() && col >= 0 && col < tam();
+    }
+    bool interior(int fila, int col) const {
+        return fila >= 1 && fila < tam() - 1 && col >= 1 && col < tam() - 1;
+    }
+
+    void asignarCelda(int fila, int col, TipoCelda t) {
+        for (int k = Muro; k <= FrutaCongelada; k++) planos[k].quitar(fila, col);
+        if (t != Vacia) planos[t].poner(fila, col);
+    }
+
+    // ¿Alguno de los planos indicados tiene la casilla?
+    template <class... T>
+    bool algunPlano(int fila, int col, T... tipos) const {
+        return Plano::algunoEn(fila, col, planos[tipos]...);
+    }
+
+    bool ocupada(int fila, int col) const {
+        return algunPlano(fila, col, Muro, Hielo, Uva, Platano, FrutaNormal, FrutaCongelada);
+    }
+
+    using Frutas = EntidadesVivas<Fruta, Cfg::MAX_FRUTAS>;
+
+    void ponerFruta(Frutas& frutas, TipoCelda tipo, int fila, int col) {
+        frutas.agregar(Fruta(static_cast<float>(col), static_cast<float>(fila), tipo));
+        asignarCelda(fila, col, tipo);
+        conFruta.poner(fila, col);
+        frutaViva.poner(fila, col);
+    }
+
+    // ¿Hay una fruta viva en las 3x3 alrededor de la casilla interior?
+    bool frutaVivaCerca(int fila, int col) const {
+        for (int fr = fila - 1; fr <= fila + 1; fr++)
+            for (int fc = col - 1; fc <= col + 1; fc++)
+                if (frutaViva.prueba(fr, fc)) return true;
+        return false;
+    }
+
+    // Las 8 vecinas en círculo, empezando arriba: las pares son las de lado
+    static constexpr int VECINA_FILA[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    static constexpr int VECINA_COL[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+    // Tramos de muro alrededor de una casilla, según cuáles de sus 8 vecinas
+    // son muro (bit k: vecina k). Los muros entre dos vecinas de lado libres
+    // forman un tramo, porque se tocan en diagonal; si no hay vecinas de lado
+    // libres, el anillo entero es uno. Bits 0-2: cuántos tramos; de 3 en 3
+    // desde el bit 3, una vecina de cada tramo.
+    static constexpr uint16_t tramosVecindadCalc(uint32_t muros) {
+        int inicio = -1;
+        for (int k = 0; k < 8 && inicio < 0; k += 2)
+            if (!((muros >> k) & 1u)) inicio = k;
+        if (inicio < 0) return 1;
+        uint16_t r = 0;
+        int n = 0;
+        bool abierto = false;
+        // Se acaba en la vecina de inicio, libre, que cierra el último tramo
+        for (int i = 1; i <= 8; i++) {
+            int k = (inicio + i) % 8;
+            if ((muros >> k) & 1u) {
+                if (!abierto) r = static_cast<uint16_t>(r | (k << (3 + 3 * n)));
+                abierto = true;
+            } else if (k % 2 == 0 && abierto) {
+                n++;
+                abierto = false;
+            }
+        }
+        return static_cast<uint16_t>(r | n);
+    }
+    static constexpr std::array<uint16_t, 256> tablaTramos() {
+        std::array<uint16_t, 256> t{};
+        for (uint32_t m = 0; m < 256; m++) t[m] = tramosVecindadCalc(m);
+        return t;
+    }
+    static uint16_t tramosVecindad(uint32_t muros) {
+        static constexpr std::array<uint16_t, 256> TABLA = tablaTramos();
+        return TABLA[muros];
+    }
+
+    // Conjunto de un muro en ponerMurosAleatorios: el borde entero es uno solo,
+    // el que sigue a las casillas
+    static constexpr int CONJUNTOS_MURO = Cfg::TAM == DINAMICO ? DINAMICO : Cfg::TAM * Cfg::TAM + 1;
+    int conjuntoMuro(int fila, int col) const {
+        return interior(fila, col) ? fila * tam() + col : tam() * tam();
+    }
+
+    // ¿Tapar la casilla interior (fila, col) separaría las casillas libres?
+    // Los muros van en conjuntos por 8-vecindad: si dos tramos de alrededor ya
+    // son del mismo conjunto, el muro nuevo cierra un anillo y lo de dentro
+    // queda aislado. Si no, deja en raices[] el conjunto de cada tramo, que
+    // son con los que hay que unir el muro al ponerlo.
+    template <class Conjuntos>
+    bool cierraHueco(Conjuntos& muros, int fila, int col, int* raices, int& numTramos) const {
+        uint32_t m = 0;
+        for (int k = 0; k < 8; k++)
+            m |= static_cast<uint32_t>(planos[Muro].prueba(fila + VECINA_FILA[k], col + VECINA_COL[k])) << k;
+        const uint16_t tramos = tramosVecindad(m);
+        numTramos = tramos & 7;
+        for (int i = 0; i < numTramos; i++) {
+            int k = (tramos >> (3 + 3 * i)) & 7;
+            raices[i] = muros.raiz(conjuntoMuro(fila + VECINA_FILA[k], col + VECINA_COL[k]));
+            for (int j = 0; j < i; j++)
+                if (raices[j] == raices[i]) return true;
+        }
+        return false;
+    }
+
+    // Pone (o quita) una línea completa de un plano, bloque a bloque
+    static void lineaCompleta(Plano& p, bool horizontal, int idx, int lado) {
+        for (int k = 0; k < p.bloquesLinea(); k++)
+            p.ponerEnBloque(horizontal, idx, k, mascaraTramo(k, 0, lado));
+    }
+
+public:
+    MapaT() = default;
+    explicit MapaT(const Cfg& c) : cfg(c) {}
+
+    int tam() const { return cfg.tam(); }
+
+    void inicializar() {
+        generacionMapa++;
+        for (auto& p : planos) p.dimensionar(tam());
+        conFruta.dimensionar(tam());
+        frutaViva.dimensionar(tam());
+        congelada.dimensionar(tam());
+        for (auto& p : planos) p.limpiar();
+        conFruta.limpiar();
+        frutaViva.limpiar();
+        congelada.limpiar();
+        lineaCompleta(planos[Muro], true, 0, tam());
+        lineaCompleta(planos[Muro], true, tam() - 1, tam());
+        lineaCompleta(planos[Muro], false, 0, tam());
+        lineaCompleta(planos[Muro], false, tam() - 1, tam());
+    }
+
+    // Entre 8 y 17 muros en el tablero clásico; en los demás, la misma densidad.
+    // Las casillas libres quedan siempre conectadas entre sí, así que desde
+    // (filaLibre, colLibre), que no se tapa nunca, se llega a todas: el muro
+    // que partiría el hueco se descarta y se sortea otra casilla (ver
+    // cierraHueco).
+    void ponerMurosAleatorios(Aleatorio& rng, int filaLibre, int colLibre) {
+        generacionMapa++;
+        int celdasInterior = (tam() - 2) * (tam() - 2);
+        int numMuros = 8 + (rng.acotado(10));
+        numMuros = static_cast<int>(static_cast<long long>(numMuros) * celdasInterior / CELDAS_INTERIOR_CLASICO);
+        numMuros = std::min(numMuros, celdasInterior / 4);
+        ConjuntosDisjuntos<CONJUNTOS_MURO> muros;
+        muros.reiniciar(tam() * tam() + 1);
+        int puestos = 0;
+        int intentos = 0;
+        const int maxIntentos = std::max(500, numMuros * 50);
+        while (puestos < numMuros && intentos < maxIntentos) {
+            intentos++;
+            int r = 1 + rng.acotado(tam() - 2);
+            int c = 1 + rng.acotado(tam() - 2);
+            int raices[4];
+            int numTramos = 0;
+            if (ocupada(r, c) || (r == filaLibre && c == colLibre) || cierraHueco(muros, r, c, raices, numTramos))
+                continue;
+            asignarCelda(r, c, Muro);
+            for (int i = 0; i < numTramos; i++) muros.unir(r * tam() + c, raices[i]);
+            puestos++;
+        }
+    }
+
+    // Muros ya sorteados, una fila por entrada (bit c = columna c); el borde
+    // puede venir o no, ya lo pone inicializar(). Solo tableros de lado fijo:
+    // cada fila cabe en un bloque.
+    void ponerMuros(const uint16_t* filas) {
+        generacionMapa++;
+        for (int f = 0; f < tam(); f++) planos[Muro].ponerEnBloque(true, f, 0, filas[f]);
+    }
+    // Fila f de los muros, como la recibe ponerMuros()
+    uint16_t filaMuros(int f) const { return static_cast<uint16_t>(planos[Muro].bloque(true, f, 0)); }
+
+    // Vista de compatibilidad: el TipoCelda de la casilla como en el arreglo original
+    TipoCelda obtenerCelda(int fila, int col) const {
+        if (!dentro(fila, col))
+            return Muro;
+        for (int t = Muro; t <= FrutaCongelada; t++)
+            if (planos[t].prueba(fila, col)) return static_cast<TipoCelda>(t);
+        return Vacia;
+    }
+
+    const Plano& plano(TipoCelda t) const { return planos[t]; }
+    const Plano& frutasVivas() const { return frutaViva; }
+    const Plano& frutasCongeladas() const { return congelada; }
+
+    void crearHielo(int fila, int col) {
+        if (interior(fila, col) && !ocupada(fila, col)) {
+            asignarCelda(fila, col, Hielo);
+            anotarCambio(fila, col);
+        }
+    }
+    void romperHielo(int fila, int col) {
+        if (dentro(fila, col) && planos[Hielo].prueba(fila, col)) {
+            asignarCelda(fila, col, Vacia);
+            anotarCambio(fila, col);
+        }
+    }
+
+    uint32_t generacion() const { return generacionMapa; }
+    uint64_t version() const { return numCambios; }
+    // f(fila, col) por cada cambio anotado desde la versión 'desde' (puede
+    // repetir casillas). Devuelve false si el registro ya no los conserva.
+    template <class F>
+    bool paraCadaCambioDesde(uint64_t desde, F&& f) const {
+        if (numCambios - desde > CAPACIDAD_CAMBIOS) return false;
+        for (uint64_t v = desde; v < numCambios; v++) {
+            const CambioCelda& c = cambios[v % CAPACIDAD_CAMBIOS];
+            f(c.fila, c.col);
+        }
+        return true;
+    }
+
+    // Rayo de congelar sobre las casillas [desde, hasta) de una línea: pone
+    // hielo en las vacías y congela las frutas vivas. alCongelar(pos) recibe la
+    // posición en la línea de cada fruta que pasó a congelada.
+    template <class F>
+    void congelarTramo(bool horizontal, int idx, int desde, int hasta, F&& alCongelar) {
+        Plano::paraBloquesTramo(desde, hasta, [&](int k, uint64_t tramo) {
+            uint64_t llenas = planos[Muro].bloque(horizontal, idx, k) | planos[Hielo].bloque(horizontal, idx, k) |
+                              conFruta.bloque(horizontal, idx, k);
+            uint64_t hielo = tramo & ~llenas;
+            planos[Hielo].ponerEnBloque(horizontal, idx, k, hielo);
+            uint64_t frutas = tramo & frutaViva.bloque(horizontal, idx, k) & ~congelada.bloque(horizontal, idx, k);
+            congelada.ponerEnBloque(horizontal, idx, k, frutas);
+            anotarBloque(horizontal, idx, k, hielo | frutas);
+            for (; frutas; frutas &= frutas - 1) alCongelar(k * 64 + bitMenor(frutas));
+        });
+    }
+    // Rayo de descongelar: rompe el hielo y libera las frutas congeladas;
+    // alDescongelar(pos) recibe cada fruta liberada.
+    template <class F>
+    void descongelarTramo(bool horizontal, int idx, int desde, int hasta, F&& alDescongelar) {
+        Plano::paraBloquesTramo(desde, hasta, [&](int k, uint64_t tramo) {
+            uint64_t hielo = tramo & planos[Hielo].bloque(horizontal, idx, k);
+            planos[Hielo].quitarEnBloque(horizontal, idx, k, hielo);
+            uint64_t frutas = tramo & congelada.bloque(horizontal, idx, k);
+            congelada.quitarEnBloque(horizontal, idx, k, frutas);
+            anotarBloque(horizontal, idx, k, hielo | frutas);
+            for (; frutas; frutas &= frutas - 1) alDescongelar(k * 64 + bitMenor(frutas));
+        });
+    }
+
+    bool hayFrutaCongelada(int fila, int col) const {
+        return dentro(fila, col) && congelada.prueba(fila, col);
+    }
+    void recogerFruta(int fila, int col) {
+        frutaViva.quitar(fila, col);
+        congelada.quitar(fila, col);
+        anotarCambio(fila, col);
+    }
+    // Fruta viva y sin congelar: la que el jugador puede recoger al pisarla
+    bool frutaAlAlcance(int fila, int col) const {
+        return frutaViva.prueba(fila, col) && !congelada.prueba(fila, col);
+    }
+    uint64_t frutasAlAlcance(bool horizontal, int idx, int k) const {
+        return frutaViva.bloque(horizontal, idx, k) & ~congelada.bloque(horizontal, idx, k);
+    }
+    bool quedanFrutas() const { return !frutaViva.vacio(); }
+
+    bool sePuedePasar(int fila, int col) const {
+        return dentro(fila, col) && !algunPlano(fila, col, Muro, Hielo, FrutaNormal, FrutaCongelada);
+    }
+    bool puedePasarEspecial(int fila, int col) const {
+        return dentro(fila, col) && !algunPlano(fila, col, Muro, FrutaNormal, FrutaCongelada);
+    }
+    // Igual que las anteriores pero tratando la fruta congelada como obstáculo
+    bool pasableNormal(int fila, int col) const {
+        return sePuedePasar(fila, col) && !congelada.prueba(fila, col);
+    }
+    bool pasableEspecial(int fila, int col) const {
+        return puedePasarEspecial(fila, col) && !congelada.prueba(fila, col);
+    }
+    // El jugador atraviesa cualquier casilla salvo muro, hielo o fruta congelada
+    bool pasableJugador(int fila, int col) const {
+        return dentro(fila, col) && !algunPlano(fila, col, Muro, Hielo) && !congelada.prueba(fila, col);
+    }
+    bool pasable(ReglaPaso regla, int fila, int col) const {
+        switch (regla) {
+            case PasoNormal:   return pasableNormal(fila, col);
+            case PasoEspecial: return pasableEspecial(fila, col);
+            default:           return pasableJugador(fila, col);
+        }
+    }
+    // Bloque k de las casillas de una línea que no se pueden pisar con la regla
+    // dada (lo mismo que pasable(), en máscara)
+    uint64_t intransitables(ReglaPaso regla, bool horizontal, int idx, int k) const {
+        uint64_t m = planos[Muro].bloque(horizontal, idx, k) | congelada.bloque(horizontal, idx, k);
+        if (regla != PasoJugador)
+            m |= planos[FrutaNormal].bloque(horizontal, idx, k) | planos[FrutaCongelada].bloque(horizontal, idx, k);
+        if (regla != PasoEspecial) m |= planos[Hielo].bloque(horizontal, idx, k);
+        return m;
+    }
+
+    // f(col) por cada casilla vacía de la fila en las columnas [desde, hasta),
+    // de izquierda a derecha: se miran todos los planos de un bloque a la vez
+    template <class F>
+    void paraVaciasEnFila(int fila, int desde, int hasta, F&& f) const {
+        Plano::paraBloquesTramo(desde, hasta, [&](int k, uint64_t tramo) {
+            uint64_t llenas = 0;
+            for (int t = Muro; t <= FrutaCongelada; t++) llenas |= planos[t].bloque(true, fila, k);
+            for (uint64_t m = tramo & ~llenas; m; m &= m - 1) f(k * 64 + bitMenor(m));
+        });
+    }
+
+    bool celdaVaciaParaSpawn(int fila, int col) const {
+        return obtenerCelda(fila, col) == Vacia;
+    }
+
+    // Cada fruta queda separada de las demás vivas por al menos una casilla.
+    // Se sortea entre las casillas que aún lo permiten: al poner una fruta se
+    // quitan del conjunto las 3x3 de su alrededor, así cada una cuesta lo mismo
+    // por lleno que esté el tablero. Si no caben todas, se ponen las que quepan.
+    // 'libres' es memoria de trabajo.
+    void ponerFrutas(Frutas& frutas, TipoCelda tipo, int cantidad, Aleatorio& rng,
+                     CasillasLibres<celdasTablero(Cfg::TAM)>& libres) {
+        generacionMapa++;
+        libres.reiniciar(tam() * tam());
+        const bool hayFrutas = !frutaViva.vacio();
+        for (int r = 1; r < tam() - 1; r++)
+            paraVaciasEnFila(r, 1, tam() - 1, [&](int c) {
+                if (!(hayFrutas && frutaVivaCerca(r, c))) libres.agregar(r * tam() + c);
+            });
+        for (int colocadas = 0; colocadas < cantidad && !libres.vacio(); colocadas++) {
+            int k = libres.sortear(rng);
+            int r = k / tam(), c = k % tam();
+            ponerFruta(frutas, tipo, r, c);
+            for (int fr = r - 1; fr <= r + 1; fr++)
+                for (int fc = c - 1; fc <= c + 1; fc++) libres.quitar(fr * tam() + fc);
+        }
+    }
+    // Frutas en casillas ya elegidas (fila * tam() + col), sin comprobar nada
+    template <class Casilla>
+    void ponerFrutasEn(Frutas& frutas, TipoCelda tipo, const Casilla* casillas, int cantidad) {
+        generacionMapa++;
+        for (int i = 0; i < cantidad; i++) ponerFruta(frutas, tipo, casillas[i] / tam(), casillas[i] % tam());
+    }
+};
+
+using Mapa = MapaT<ConfigClasica>;
+
+#endif // NUCLEO_MAPA_H
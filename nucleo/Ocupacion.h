@@ -0,0 +1,78 @@
+#ifndef NUCLEO_OCUPACION_H
+#define NUCLEO_OCUPACION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "Bitboard.h"
+#include "Config.h"
+
+// Índice por celda de las entidades del tablero: qué fruta viva hay en cada
+// casilla (su puesto en Juego::frutas; como mucho una, por la regla de
+// separación de ponerFrutas) y cuántos enemigos vivos la pisan, con un plano
+// de bits de las casillas con enemigos para los rayos de hielo. Que la fruta
+// esté congelada lo guarda el Mapa. Juego lo mantiene al día cuando se recoge
+// una fruta (y la última ocupa su puesto) y cuando un enemigo cambia de
+// celda, así cada consulta es O(1) en lugar de recorrer frutas[] o enemigos[].
+template <class Cfg>
+class OcupacionT {
+public:
+    static constexpr int SIN_FRUTA = -1;
+
+private:
+    // Con tope fijo de enemigos basta un contador de 16 bits por casilla; la
+    // horda no tiene tope y en una casilla pueden amontonarse más de 65535
+    using Contador = typename std::conditional<Cfg::MAX_ENEMIGOS == DINAMICO, uint32_t, uint16_t>::type;
+
+    // Por casilla, en dos arreglos: los enemigos se mueven en cada tick y
+    // así sus contadores se recorren sin arrastrar los de las frutas
+    Cfg cfg;
+    Almacen<int32_t, celdasTablero(Cfg::TAM)> frutas;
+    Almacen<Contador, celdasTablero(Cfg::TAM)> enemigos;
+    PlanoBits<Cfg::TAM> conEnemigos;
+
+    bool dentro(int fila, int col) const {
+        return fila >= 0 && fila < cfg.tam() && col >= 0 && col < cfg.tam();
+    }
+    int celda(int fila, int col) const { return fila * cfg.tam() + col; }
+
+public:
+    OcupacionT() = default;
+    explicit OcupacionT(const Cfg& c) : cfg(c) {}
+
+    void limpiar() {
+        dimensionar(frutas, cfg.tam() * cfg.tam());
+        dimensionar(enemigos, cfg.tam() * cfg.tam());
+        std::fill(frutas.begin(), frutas.end(), SIN_FRUTA);
+        std::fill(enemigos.begin(), enemigos.end(), 0);
+        conEnemigos.dimensionar(cfg.tam());
+        conEnemigos.limpiar();
+    }
+
+    int frutaEn(int fila, int col) const {
+        return dentro(fila, col) ? frutas[celda(fila, col)] : SIN_FRUTA;
+    }
+    void ponerFruta(int fila, int col, int idx) { frutas[celda(fila, col)] = idx; }
+    void quitarFruta(int fila, int col) { frutas[celda(fila, col)] = SIN_FRUTA; }
+
+    int enemigosEn(int fila, int col) const {
+        return dentro(fila, col) ? enemigos[celda(fila, col)] : 0;
+    }
+    const PlanoBits<Cfg::TAM>& planoEnemigos() const { return conEnemigos; }
+    void entraEnemigo(int fila, int col) {
+        if (enemigos[celda(fila, col)]++ == 0) conEnemigos.poner(fila, col);
+    }
+    void saleEnemigo(int fila, int col) {
+        if (--enemigos[celda(fila, col)] == 0) conEnemigos.quitar(fila, col);
+    }
+    void moverEnemigo(int filaAnt, int colAnt, int fila, int col) {
+        if (filaAnt == fila && colAnt == col) return;
+        saleEnemigo(filaAnt, colAnt);
+        entraEnemigo(fila, col);
+    }
+};
+
+using Ocupacion = OcupacionT<ConfigClasica>;
+
+#endif // NUCLEO_OCUPACION_H
@@ -0,0 +1,124 @@
+#include "PaqueteNiveles.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIA[4] = {'I', 'C', 'P', 'N'};
+
+// Proyecta el archivo entero en solo lectura; nullptr si no se puede. Las
+// asas del archivo se cierran enseguida: la proyección se sostiene sola.
+const uint8_t* proyectar(const std::string& ruta, size_t& bytes) {
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(ruta.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER tam;
+    const void* vista = nullptr;
+    if (GetFileSizeEx(archivo, &tam) && tam.QuadPart > 0) {
+        HANDLE mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapeo) {
+            vista = MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapeo);
+        }
+        bytes = static_cast<size_t>(tam.QuadPart);
+    }
+    CloseHandle(archivo);
+    return static_cast<const uint8_t*>(vista);
+#else
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    void* vista = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        bytes = static_cast<size_t>(st.st_size);
+        vista = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    return vista == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(vista);
+#endif
+}
+
+void liberar(const uint8_t* base, size_t bytes) {
+#ifdef _WIN32
+    (void)bytes;
+    UnmapViewOfFile(base);
+#else
+    munmap(const_cast<uint8_t*>(base), bytes);
+#endif
+}
+
+} // namespace
+
+PaqueteNiveles::Cabecera PaqueteNiveles::cabeceraEsperada() {
+    Cabecera c{};
+    std::memcpy(c.magia, MAGIA, sizeof(MAGIA));
+    c.version = VERSION;
+    c.ordenBytes = ORDEN_BYTES;
+    c.tamNivel = sizeof(NivelEmpaquetado);
+    c.lado = ConfigClasica::TAM;
+    c.maxEnemigos = ConfigClasica::MAX_ENEMIGOS;
+    c.maxFrutas = ConfigClasica::MAX_FRUTAS;
+    return c;
+}
+
+bool PaqueteNiveles::abrir(const std::string& ruta) {
+    cerrar();
+    size_t n = 0;
+    const uint8_t* p = proyectar(ruta, n);
+    if (!p) return false;
+    base = p;
+    bytes = n;
+
+    // Todo lo que se comprueba aquí es la cabecera: abrir no depende del total
+    const Cabecera e = cabeceraEsperada();
+    bool valido = bytes >= sizeof(Cabecera);
+    if (valido) {
+        const Cabecera& c = cabecera();
+        valido = std::memcmp(c.magia, e.magia, sizeof(MAGIA)) == 0 && c.version == e.version &&
+                 c.ordenBytes == e.ordenBytes && c.tamNivel == e.tamNivel && c.lado == e.lado &&
+                 c.maxEnemigos == e.maxEnemigos && c.maxFrutas == e.maxFrutas && c.primero[1] == 0;
+        for (int k = 1; valido && k <= MAX_NIVEL; k++) valido = c.primero[k] <= c.primero[k + 1];
+        valido = valido && c.primero[MAX_NIVEL + 1] <= (bytes - sizeof(Cabecera)) / sizeof(NivelEmpaquetado) &&
+                 sizeof(Cabecera) + c.primero[MAX_NIVEL + 1] * sizeof(NivelEmpaquetado) == bytes;
+    }
+    if (!valido) cerrar();
+    return valido;
+}
+
+void PaqueteNiveles::cerrar() {
+    if (base) liberar(base, bytes);
+    base = nullptr;
+    bytes = 0;
+}
+
+bool PaqueteNiveles::escribir(const std::string& ruta, std::vector<NivelEmpaquetado> lista) {
+    lista.erase(std::remove_if(lista.begin(), lista.end(),
+                               [](const NivelEmpaquetado& e) { return e.nivel < 1 || e.nivel > MAX_NIVEL; }),
+                lista.end());
+    std::stable_sort(lista.begin(), lista.end(),
+                     [](const NivelEmpaquetado& a, const NivelEmpaquetado& b) { return a.nivel < b.nivel; });
+    Cabecera c = cabeceraEsperada();
+    size_t i = 0;
+    for (int k = 1; k <= MAX_NIVEL + 1; k++) {
+        while (i < lista.size() && lista[i].nivel < k) i++;
+        c.primero[k] = i;
+    }
+    std::ofstream f(ruta, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(&c), sizeof(c));
+    f.write(reinterpret_cast<const char*>(lista.data()),
+            static_cast<std::streamsize>(lista.size() * sizeof(NivelEmpaquetado)));
+    return static_cast<bool>(f);
+}
@@ -0,0 +1,186 @@
+#ifndef NUCLEO_PAQUETENIVELES_H
+#define NUCLEO_PAQUETENIVELES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "CampoDistancias.h"
+#include "Juego.h"
+
+// Un nivel ya generado: lo que iniciarNivel() sortea (muros, casilla del
+// jugador, enemigos y frutas) y el generador tal como queda después, para que
+// la partida siga exactamente igual que si se hubiera generado con su semilla.
+// Las casillas van como índice fila * TAM + col. Solo tableros de lado fijo de
+// hasta 16 casillas: cada fila de muros cabe en 16 bits.
+template <class Cfg>
+struct NivelEmpaquetadoT {
+    static_assert(Cfg::TAM != DINAMICO && Cfg::TAM <= 16, "Solo tableros fijos de hasta 16 de lado");
+
+    uint64_t semilla = 0;
+    uint64_t rng[4] = {};
+    uint16_t muros[Cfg::TAM] = {}; // bit c de la fila f: muro en (f, c)
+    uint8_t nivel = 0;
+    uint8_t jugador = 0;
+    uint8_t numEnemigos = 0;
+    uint8_t numFrutas = 0;
+    uint8_t enemigos[Cfg::MAX_ENEMIGOS] = {};
+    uint8_t cambioEnemigos[Cfg::MAX_ENEMIGOS] = {}; // ticksParaCambiar al empezar
+    uint8_t frutas[Cfg::MAX_FRUTAS] = {};
+
+    // Lo mínimo para empezarlo sin salirse de los arreglos ni romper lo que
+    // Juego da por hecho: nadie dentro de un muro y como mucho una fruta por
+    // casilla, que es lo que cabe en Ocupacion (un paquete puede venir
+    // corrupto: se comprueba cada nivel al usarlo, no al abrir)
+    bool coherente() const {
+        constexpr int CELDAS = Cfg::TAM * Cfg::TAM;
+        Cfg cfg;
+        if (nivel < 1 || nivel > MAX_NIVEL || numEnemigos != cfg.enemigosNivel(nivel) || numFrutas > Cfg::MAX_FRUTAS)
+            return false;
+        auto libre = [this](int casilla) {
+            return casilla < CELDAS && !((muros[casilla / Cfg::TAM] >> (casilla % Cfg::TAM)) & 1u);
+        };
+        if (!libre(jugador)) return false;
+        for (int i = 0; i < numEnemigos; i++)
+            if (!libre(enemigos[i])) return false;
+        uint16_t conFruta[Cfg::TAM] = {};
+        for (int i = 0; i < numFrutas; i++) {
+            if (!libre(frutas[i])) return false;
+            uint16_t bit = static_cast<uint16_t>(1u << (frutas[i] % Cfg::TAM));
+            if (conFruta[frutas[i] / Cfg::TAM] & bit) return false;
+            conFruta[frutas[i] / Cfg::TAM] |= bit;
+        }
+        return true;
+    }
+};
+
+using NivelEmpaquetado = NivelEmpaquetadoT<ConfigClasica>;
+static_assert(std::is_trivially_copyable<NivelEmpaquetado>::value && std::is_standard_layout<NivelEmpaquetado>::value,
+              "Los niveles se leen tal cual del archivo proyectado");
+
+// Nivel de una partida recién iniciada con iniciarNivel()
+template <class Cfg>
+NivelEmpaquetadoT<Cfg> empaquetarNivel(const JuegoT<Cfg>& j) {
+    NivelEmpaquetadoT<Cfg> e;
+    e.semilla = j.semilla;
+    j.rng.leerEstado(e.rng);
+    for (int f = 0; f < Cfg::TAM; f++) e.muros[f] = j.mapa.filaMuros(f);
+    auto casilla = [](const Posicion& p) { return static_cast<uint8_t>(p.celdaY() * Cfg::TAM + p.celdaX()); };
+    e.nivel = static_cast<uint8_t>(j.nivel);
+    e.jugador = casilla(j.jugador.pos);
+    e.numEnemigos = static_cast<uint8_t>(j.numEnemigos);
+    for (int i = 0; i < j.numEnemigos; i++) {
+        e.enemigos[i] = casilla(j.enemigos[i].pos);
+        e.cambioEnemigos[i] = static_cast<uint8_t>(j.enemigos[i].ticksParaCambiar);
+    }
+    e.numFrutas = static_cast<uint8_t>(j.frutas.tamano());
+    for (int i = 0; i < j.frutas.tamano(); i++) e.frutas[i] = casilla(j.frutas[i].pos);
+    return e;
+}
+
+// Empieza el nivel sin sortear nada: deja la partida igual que
+// iniciarNivel(e.nivel, e.semilla). false (y la partida sin tocar) si el
+// nivel no es coherente.
+template <class Cfg>
+bool iniciarNivelEmpaquetado(JuegoT<Cfg>& j, const NivelEmpaquetadoT<Cfg>& e) {
+    if (!e.coherente()) return false;
+    j.reiniciarNivel(e.nivel, e.semilla);
+    j.mapa.ponerMuros(e.muros);
+    j.jugador.pos = Posicion(static_cast<float>(e.jugador % Cfg::TAM), static_cast<float>(e.jugador / Cfg::TAM));
+    for (int i = 0; i < e.numEnemigos; i++)
+        j.ponerEnemigo(i, e.enemigos[i] / Cfg::TAM, e.enemigos[i] % Cfg::TAM, e.cambioEnemigos[i]);
+    j.mapa.ponerFrutasEn(j.frutas, Uva, e.frutas, e.numFrutas);
+    j.rng.fijarEstado(e.rng);
+    j.cerrarNivel();
+    return true;
+}
+
+// Lo que iniciarNivel() no garantiza y un nivel empaquetado sí: todas las
+// frutas pedidas, el jugador en una casilla libre desde la que llega a todas,
+// y cada enemigo en una casilla libre, solo y a más de 2 pasos del jugador.
+// 'campo' es memoria de trabajo (PasoJugador).
+template <class Cfg>
+bool nivelJugable(const JuegoT<Cfg>& j, CampoDistancias<Cfg>& campo) {
+    const int pr = j.jugador.pos.celdaY(), pc = j.jugador.pos.celdaX();
+    if (j.frutas.tamano() != j.cfg.uvasNivel(j.nivel) || j.mapa.obtenerCelda(pr, pc) != Vacia) return false;
+    for (int i = 0; i < j.numEnemigos; i++) {
+        const int er = j.enemigos[i].pos.celdaY(), ec = j.enemigos[i].pos.celdaX();
+        if (j.mapa.obtenerCelda(er, ec) != Vacia || j.ocupacion.enemigosEn(er, ec) != 1 ||
+            std::abs(er - pr) + std::abs(ec - pc) <= 2)
+            return false;
+    }
+    campo.actualizar(j.mapa, pr, pc);
+    for (const Fruta& f : j.frutas) {
+        int32_t d = campo.distancia(f.pos.celdaY(), f.pos.celdaX());
+        if (d == CampoDistancias<Cfg>::INALCANZABLE || d == CampoDistancias<Cfg>::BLOQUEADA) return false;
+    }
+    return true;
+}
+
+// Archivo de niveles del tablero clásico, proyectado en memoria: abrir() no
+// lee nada y nivel() devuelve una referencia dentro de la proyección, así que
+// empezar un nivel cuesta lo mismo con diez niveles que con un millón. Los
+// niveles van ordenados por número y la cabecera guarda dónde empieza cada
+// uno, para elegir uno al azar de un nivel dado sin recorrer nada.
+//
+//   Cabecera | NivelEmpaquetado * total
+//
+// Los bytes son los de la memoria, como en Guardado.h: la cabecera lleva
+// versión, orden de bytes y tamaños, y lo que no case se rechaza al abrir.
+class PaqueteNiveles {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int MAX_NIVEL = ::MAX_NIVEL;
+
+    PaqueteNiveles() = default;
+    ~PaqueteNiveles() { cerrar(); }
+    PaqueteNiveles(const PaqueteNiveles&) = delete;
+    PaqueteNiveles& operator=(const PaqueteNiveles&) = delete;
+
+    // false (y cerrado) si no existe o no es un paquete de este formato
+    bool abrir(const std::string& ruta);
+    void cerrar();
+    bool abierto() const { return base != nullptr; }
+
+    size_t total() const { return abierto() ? static_cast<size_t>(cabecera().primero[MAX_NIVEL + 1]) : 0; }
+    size_t cuantos(int nivel) const {
+        if (!abierto() || nivel < 1 || nivel > MAX_NIVEL) return 0;
+        return static_cast<size_t>(cabecera().primero[nivel + 1] - cabecera().primero[nivel]);
+    }
+    // k-ésimo nivel número 'nivel', con k < cuantos(nivel)
+    const NivelEmpaquetado& nivel(int nivel, size_t k) const { return niveles()[cabecera().primero[nivel] + k]; }
+    const NivelEmpaquetado& operator[](size_t i) const { return niveles()[i]; }
+
+    // Ordena por número (estable) y escribe; los de número fuera de 1..MAX_NIVEL se descartan
+    static bool escribir(const std::string& ruta, std::vector<NivelEmpaquetado> lista);
+
+private:
+    struct Cabecera {
+        char magia[4];
+        uint32_t version;
+        uint32_t ordenBytes; // ORDEN_BYTES tal como lo escribió la máquina que lo generó
+        uint32_t tamNivel;
+        uint32_t lado;
+        uint32_t maxEnemigos;
+        uint32_t maxFrutas;
+        uint32_t reservado;
+        // primero[n]: índice del primer nivel número n; primero[MAX_NIVEL + 1] es el total
+        uint64_t primero[MAX_NIVEL + 2];
+    };
+    static_assert(sizeof(Cabecera) % alignof(NivelEmpaquetado) == 0, "Los niveles deben quedar alineados");
+    static constexpr uint32_t ORDEN_BYTES = 0x01020304;
+
+    const uint8_t* base = nullptr;
+    size_t bytes = 0;
+
+    const Cabecera& cabecera() const { return *reinterpret_cast<const Cabecera*>(base); }
+    const NivelEmpaquetado* niveles() const {
+        return reinterpret_cast<const NivelEmpaquetado*>(base + sizeof(Cabecera));
+    }
+    static Cabecera cabeceraEsperada();
+};
+
+#endif // NUCLEO_PAQUETENIVELES_H
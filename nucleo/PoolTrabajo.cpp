@@ -0,0 +1,80 @@
+#include "PoolTrabajo.h"
+
+#include <algorithm>
+
+PoolTrabajo::PoolTrabajo(int numHilos) {
+    if (numHilos <= 0) numHilos = static_cast<int>(std::thread::hardware_concurrency());
+    numHilos = std::max(numHilos, 1);
+    for (int i = 0; i < numHilos; i++) colas.push_back(std::make_unique<Cola>());
+    for (int i = 0; i < numHilos; i++) hilos.emplace_back([this, i]() { bucle(i); });
+}
+
+PoolTrabajo::~PoolTrabajo() {
+    {
+        std::lock_guard<std::mutex> lk(mEstado);
+        salir = true;
+    }
+    cvTrabajo.notify_all();
+    for (auto& h : hilos) h.join();
+}
+
+void PoolTrabajo::paraCada(int numTareas, const std::function<void(int, int)>& f) {
+    if (numTareas <= 0) return;
+    // Reparto inicial en bloques contiguos; el robo corrige el desbalance
+    int n = numHilos();
+    for (int i = 0; i < n; i++) {
+        std::lock_guard<std::mutex> lk(colas[i]->m);
+        int desde = static_cast<int>(static_cast<long long>(numTareas) * i / n);
+        int hasta = static_cast<int>(static_cast<long long>(numTareas) * (i + 1) / n);
+        for (int t = desde; t < hasta; t++) colas[i]->tareas.push_back(t);
+    }
+    std::unique_lock<std::mutex> lk(mEstado);
+    trabajo = &f;
+    hilosActivos = n;
+    generacion++;
+    cvTrabajo.notify_all();
+    cvFin.wait(lk, [this]() { return hilosActivos == 0; });
+    trabajo = nullptr;
+}
+
+bool PoolTrabajo::sacarPropia(int hilo, int& tarea) {
+    Cola& c = *colas[hilo];
+    std::lock_guard<std::mutex> lk(c.m);
+    if (c.tareas.empty()) return false;
+    tarea = c.tareas.back();
+    c.tareas.pop_back();
+    return true;
+}
+
+bool PoolTrabajo::robar(int hilo, int& tarea) {
+    int n = numHilos();
+    for (int k = 1; k < n; k++) {
+        Cola& c = *colas[(hilo + k) % n];
+        std::lock_guard<std::mutex> lk(c.m);
+        if (c.tareas.empty()) continue;
+        tarea = c.tareas.front();
+        c.tareas.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void PoolTrabajo::bucle(int hilo) {
+    int vista = 0;
+    for (;;) {
+        const std::function<void(int, int)>* f = nullptr;
+        {
+            std::unique_lock<std::mutex> lk(mEstado);
+            cvTrabajo.wait(lk, [&]() { return salir || generacion != vista; });
+            if (salir) return;
+            vista = generacion;
+            f = trabajo;
+        }
+        // Las tareas no generan tareas nuevas: si no queda nada propio ni que
+        // robar, este hilo ya terminó su parte del lote
+        int tarea;
+        while (sacarPropia(hilo, tarea) || robar(hilo, tarea)) (*f)(tarea, hilo);
+        std::lock_guard<std::mutex> lk(mEstado);
+        if (--hilosActivos == 0) cvFin.notify_one();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef NUCLEO_POOLTRABAJO_H
+#define NUCLEO_POOLTRABAJO_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos con robo de trabajo. Cada hilo tiene su propia cola de tareas:
+// saca del final de la suya y, cuando se le acaba, roba del principio de la de
+// otro. Así las partidas largas no dejan núcleos ociosos al final del lote.
+class PoolTrabajo {
+public:
+    // hilos <= 0 usa todos los núcleos disponibles
+    explicit PoolTrabajo(int hilos = 0);
+    ~PoolTrabajo();
+
+    PoolTrabajo(const PoolTrabajo&) = delete;
+    PoolTrabajo& operator=(const PoolTrabajo&) = delete;
+
+    int numHilos() const { return static_cast<int>(hilos.size()); }
+
+    // Ejecuta f(tarea, hilo) para tarea en [0, numTareas) y espera a que terminen.
+    // 'hilo' está en [0, numHilos()) y permite acumular resultados sin contención.
+    void paraCada(int numTareas, const std::function<void(int tarea, int hilo)>& f);
+
+private:
+    struct Cola {
+        std::mutex m;
+        std::deque<int> tareas;
+    };
+
+    bool sacarPropia(int hilo, int& tarea);
+    bool robar(int hilo, int& tarea);
+    void bucle(int hilo);
+
+    std::vector<std::thread> hilos;
+    std::vector<std::unique_ptr<Cola>> colas;
+    std::mutex mEstado;
+    std::condition_variable cvTrabajo, cvFin;
+    const std::function<void(int, int)>* trabajo = nullptr;
+    int generacion = 0;
+    int hilosActivos = 0;
+    bool salir = false;
+};
+
+#endif // NUCLEO_POOLTRABAJO_H
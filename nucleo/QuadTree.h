@@ -0,0 +1,170 @@
+#ifndef NUCLEO_QUADTREE_H
+#define NUCLEO_QUADTREE_H
+
+#include <vector>
+
+#include "Constantes.h"
+
+// ============= QuadTree (partición espacial para colisiones) =============
+struct PointQT {
+    double x, y;
+    PointQT() : x(0), y(0) {}
+    PointQT(double _x, double _y) : x(_x), y(_y) {}
+    bool operator==(const PointQT& o) const { return x == o.x && y == o.y; }
+};
+
+struct RectQT {
+    double x, y, ancho, alto;
+    RectQT() : x(0), y(0), ancho(0), alto(0) {}
+    RectQT(double _x, double _y, double _w, double _h) : x(_x), y(_y), ancho(_w), alto(_h) {}
+    bool contiene(const PointQT& p) const {
+        return p.x >= x && p.x <= x + ancho && p.y >= y && p.y <= y + alto;
+    }
+    bool intersecta(const RectQT& r) const {
+        return !(r.x > x + ancho || r.x + r.ancho < x || r.y > y + alto || r.y + r.alto < y);
+    }
+};
+
+// Los nodos viven en un arreglo contiguo (arena) y los cuatro hijos de un nodo
+// son consecutivos. Los puntos van en otro arreglo plano y cada hoja guarda una
+// lista enlazada por índices. limpiar() solo vacía ambos arreglos sin liberar su
+// capacidad, así que reconstruir el árbol en cada tick no toca el heap.
+class QuadTree {
+    static const int CAPACIDAD = 4;
+    static const int PROF_MAX = 6;
+    static const int NINGUNO = -1;
+
+    struct Nodo {
+        double x1, y1, x2, y2;
+        int hijos = NINGUNO;       // índice del hijo nw; ne, sw y se le siguen
+        int primerPunto = NINGUNO; // cabeza de la lista de puntos (solo hojas)
+        int numPuntos = 0;
+        int profundidad = 0;
+
+        Nodo(double _x1, double _y1, double _x2, double _y2, int prof)
+            : x1(_x1), y1(_y1), x2(_x2), y2(_y2), profundidad(prof) {}
+
+        bool esHoja() const { return hijos == NINGUNO; }
+
+        bool contiene(double px, double py) const {
+            return px >= x1 && px <= x2 && py >= y1 && py <= y2;
+        }
+
+        bool intersecta(const RectQT& r) const {
+            return !(r.x > x2 || r.x + r.ancho < x1 || r.y > y2 || r.y + r.alto < y1);
+        }
+    };
+
+    struct PuntoNodo {
+        PointQT p;
+        int siguiente;
+    };
+
+    std::vector<Nodo> nodos;
+    std::vector<PuntoNodo> puntos;
+    double boundX1 = 0, boundY1 = 0, boundX2 = TAM_TABLERO, boundY2 = TAM_TABLERO;
+
+    // Índice del hijo de n (nw, ne, sw, se en ese orden de prioridad) que contiene p
+    int hijoPara(const Nodo& n, double px, double py) const {
+        for (int k = 0; k < 3; k++)
+            if (nodos[n.hijos + k].contiene(px, py)) return n.hijos + k;
+        return n.hijos + 3;
+    }
+
+    void subdividir(int idx) {
+        int primero = static_cast<int>(nodos.size());
+        // Copias: emplace_back puede reubicar el arreglo
+        double x1 = nodos[idx].x1, y1 = nodos[idx].y1, x2 = nodos[idx].x2, y2 = nodos[idx].y2;
+        int prof = nodos[idx].profundidad + 1;
+        double mx = (x1 + x2) / 2.0, my = (y1 + y2) / 2.0;
+        nodos.emplace_back(x1, y1, mx, my, prof);
+        nodos.emplace_back(mx, y1, x2, my, prof);
+        nodos.emplace_back(x1, my, mx, y2, prof);
+        nodos.emplace_back(mx, my, x2, y2, prof);
+
+        Nodo& n = nodos[idx];
+        n.hijos = primero;
+        // Los puntos no se copian: solo se reenlazan en la lista del hijo
+        int p = n.primerPunto;
+        while (p != NINGUNO) {
+            int sig = puntos[p].siguiente;
+            Nodo& h = nodos[hijoPara(n, puntos[p].p.x, puntos[p].p.y)];
+            puntos[p].siguiente = h.primerPunto;
+            h.primerPunto = p;
+            h.numPuntos++;
+            p = sig;
+        }
+        n.primerPunto = NINGUNO;
+        n.numPuntos = 0;
+    }
+
+    // Recorre en profundidad los nodos que tocan el rango; visitar(p) devuelve
+    // true para cortar la búsqueda. Pila fija: como mucho 3 hermanos pendientes
+    // por nivel más el nodo actual.
+    template <class F>
+    void recorrerRango(const RectQT& rango, F&& visitar) const {
+        int pila[3 * PROF_MAX + 4];
+        int tope = 0;
+        pila[tope++] = 0;
+        while (tope > 0) {
+            const Nodo& n = nodos[pila[--tope]];
+            if (!n.intersecta(rango)) continue;
+            if (n.esHoja()) {
+                for (int p = n.primerPunto; p != NINGUNO; p = puntos[p].siguiente)
+                    if (rango.contiene(puntos[p].p) && visitar(puntos[p].p)) return;
+                continue;
+            }
+            for (int k = 3; k >= 0; k--) pila[tope++] = n.hijos + k;
+        }
+    }
+
+public:
+    QuadTree(double x1, double y1, double x2, double y2)
+        : boundX1(x1), boundY1(y1), boundX2(x2), boundY2(y2) {
+        nodos.reserve(1 + 4 * 8);
+        puntos.reserve(4 * CAPACIDAD);
+        limpiar();
+    }
+
+    void limpiar() {
+        nodos.clear();
+        puntos.clear();
+        nodos.emplace_back(boundX1, boundY1, boundX2, boundY2, 0);
+    }
+
+    void reiniciar(double x1, double y1, double x2, double y2) {
+        boundX1 = x1; boundY1 = y1; boundX2 = x2; boundY2 = y2;
+        limpiar();
+    }
+
+    bool insertar(double x, double y) {
+        if (!nodos[0].contiene(x, y)) return false;
+        int idx = 0;
+        for (;;) {
+            Nodo& n = nodos[idx];
+            if (n.esHoja()) {
+                if (n.numPuntos < CAPACIDAD || n.profundidad >= PROF_MAX) {
+                    puntos.push_back({PointQT(x, y), n.primerPunto});
+                    n.primerPunto = static_cast<int>(puntos.size()) - 1;
+                    n.numPuntos++;
+                    return true;
+                }
+                subdividir(idx);
+            }
+            idx = hijoPara(nodos[idx], x, y);
+        }
+    }
+
+    void consultarRango(double x, double y, double w, double h, std::vector<PointQT>& out) const {
+        out.clear();
+        recorrerRango(RectQT(x, y, w, h), [&](const PointQT& p) { out.push_back(p); return false; });
+    }
+
+    bool hayPuntosEnCelda(double cx, double cy) const {
+        bool hay = false;
+        recorrerRango(RectQT(cx, cy, 1.0, 1.0), [&](const PointQT&) { hay = true; return true; });
+        return hay;
+    }
+};
+
+#endif // NUCLEO_QUADTREE_H
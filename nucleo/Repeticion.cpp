@@ -0,0 +1,95 @@
+#include "Repeticion.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "Varint.h"
+
+namespace {
+
+constexpr char MAGIA[4] = {'I', 'C', 'R', 'P'};
+constexpr uint8_t BANDERA_BOT = 0x1;
+constexpr uint8_t BANDERA_RESULTADO = 0x2;
+
+} // namespace
+
+std::vector<uint8_t> Repeticion::codificar() const {
+    std::vector<uint8_t> b(MAGIA, MAGIA + 4);
+    b.reserve(32 + eventos.size());
+    b.push_back(VERSION);
+    escribirVarint(b, static_cast<uint64_t>(lado));
+    escribirVarint(b, static_cast<uint64_t>(nivel));
+    escribirVarint(b, semilla);
+    escribirVarint(b, static_cast<uint64_t>(ticksPorSegundo));
+    b.push_back(static_cast<uint8_t>((esBot ? BANDERA_BOT : 0) | (hayResultado ? BANDERA_RESULTADO : 0)));
+    escribirVarint(b, eventos.size());
+    int anterior = 0;
+    for (const auto& e : eventos) {
+        uint64_t delta = static_cast<uint64_t>(e.tick - anterior);
+        escribirVarint(b, (delta << BITS_CODIGO_ORDEN) | codigoOrden(e.orden));
+        anterior = e.tick;
+    }
+    if (hayResultado) {
+        escribirVarint(b, static_cast<uint64_t>(ticksFinal));
+        b.push_back(static_cast<uint8_t>(estadoFinal));
+        escribirVarint(b, static_cast<uint64_t>(frutasFinal));
+    }
+    return b;
+}
+
+bool Repeticion::decodificar(const uint8_t* datos, size_t n, Repeticion& r) {
+    const uint8_t* p = datos;
+    const uint8_t* fin = datos + n;
+    if (n < 5 || !std::equal(MAGIA, MAGIA + 4, p) || p[4] != VERSION) return false;
+    p += 5;
+
+    constexpr uint64_t MAX_INT = 0x7FFFFFFF;
+    Repeticion leida;
+    uint64_t numEventos;
+    if (!leerEntero(p, fin, leida.lado, MAX_INT) || !leerEntero(p, fin, leida.nivel, MAX_NIVEL) || leida.nivel < 1 ||
+        !leerVarint(p, fin, leida.semilla) || !leerEntero(p, fin, leida.ticksPorSegundo, MAX_TICKS_POR_SEGUNDO) ||
+        leida.ticksPorSegundo == 0 || p == fin)
+        return false;
+    uint8_t banderas = *p++;
+    leida.esBot = banderas & BANDERA_BOT;
+    leida.hayResultado = banderas & BANDERA_RESULTADO;
+    // Cada evento ocupa al menos un byte: no se reserva más de lo que hay
+    if (!leerVarint(p, fin, numEventos) || numEventos > static_cast<uint64_t>(fin - p)) return false;
+
+    leida.eventos.resize(numEventos);
+    uint64_t tick = 0;
+    for (auto& e : leida.eventos) {
+        uint64_t v;
+        if (!leerVarint(p, fin, v)) return false;
+        tick += v >> BITS_CODIGO_ORDEN;
+        if (tick > MAX_INT || !ordenDeCodigo(static_cast<uint32_t>(v & ((1u << BITS_CODIGO_ORDEN) - 1)), e.orden))
+            return false;
+        e.tick = static_cast<int>(tick);
+    }
+    if (leida.hayResultado) {
+        if (!leerEntero(p, fin, leida.ticksFinal, MAX_INT) || p == fin) return false;
+        uint8_t estado = *p++;
+        if (estado > Perdiste) return false;
+        leida.estadoFinal = static_cast<EstadoJuego>(estado);
+        if (!leerEntero(p, fin, leida.frutasFinal, MAX_INT)) return false;
+    }
+    if (p != fin) return false;
+    r = std::move(leida);
+    return true;
+}
+
+bool Repeticion::guardar(const std::string& ruta) const {
+    std::vector<uint8_t> b = codificar();
+    std::ofstream f(ruta, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(b.data()), static_cast<std::streamsize>(b.size()));
+    return static_cast<bool>(f);
+}
+
+bool Repeticion::cargar(const std::string& ruta, Repeticion& r) {
+    std::ifstream f(ruta, std::ios::binary);
+    if (!f) return false;
+    std::vector<uint8_t> b((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    return decodificar(b.data(), b.size(), r);
+}
@@ -0,0 +1,127 @@
+#ifndef NUCLEO_REPETICION_H
+#define NUCLEO_REPETICION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Juego.h"
+
+// Orden del jugador y el tick (ticksDesdeInicio) en el que se aplicó, es decir,
+// antes del actualizar() que lleva la partida a tick + 1
+struct EventoRepeticion {
+    int tick = 0;
+    Orden orden;
+};
+
+// Partida grabada: la semilla del nivel más las órdenes del jugador por tick.
+// Como JuegoT es determinista con la misma semilla y las mismas entradas,
+// basta para volver a jugarla entera, en tiempo real o a toda velocidad.
+//
+// Formato binario (enteros sin signo en varint LEB128, de 7 en 7 bits):
+//   "ICRP" versión(1 byte)
+//   lado nivel semilla ticksPorSegundo banderas(1 byte: esBot, hayResultado)
+//   numEventos, y por evento ((tick - tickAnterior) << 3 | código)
+//   [ticksFinal estadoFinal frutasRecogidas] si hayResultado
+// El código es el de codigoOrden() (3 bits), así que casi todos los eventos
+// ocupan un solo byte.
+struct Repeticion {
+    static constexpr uint8_t VERSION = 3;
+
+    int lado = 0; // cfg.tam() de la partida; la Cfg debe coincidir al reproducir
+    int nivel = 1;
+    uint64_t semilla = 0;
+    int ticksPorSegundo = TICKS_POR_SEGUNDO;
+    bool esBot = false;
+    std::vector<EventoRepeticion> eventos;
+
+    // Cómo acabó al grabarla, para comprobar que el motor la reproduce igual
+    bool hayResultado = false;
+    int ticksFinal = 0;
+    EstadoJuego estadoFinal = Jugando;
+    int frutasFinal = 0;
+
+    // Toma la cabecera de una partida recién iniciada y vacía los eventos
+    template <class Cfg>
+    void empezar(const JuegoT<Cfg>& j) {
+        lado = j.cfg.tam();
+        nivel = j.nivel;
+        semilla = j.semilla;
+        ticksPorSegundo = j.ticksPorSegundo;
+        esBot = j.esBot;
+        eventos.clear();
+        hayResultado = false;
+    }
+
+    // Solo cuenta lo que llega con la partida en juego: lo demás no la cambia
+    template <class Cfg>
+    void anotar(const JuegoT<Cfg>& j, const Orden& o) {
+        if (j.estado == Jugando) eventos.push_back({j.ticksDesdeInicio, o});
+    }
+
+    template <class Cfg>
+    void cerrar(const JuegoT<Cfg>& j) {
+        hayResultado = j.estado == Ganaste || j.estado == Perdiste;
+        ticksFinal = j.ticksDesdeInicio;
+        estadoFinal = j.estado;
+        frutasFinal = j.jugador.frutas_recogidas;
+    }
+
+    std::vector<uint8_t> codificar() const;
+    // false (y r sin tocar) si los bytes no son una repetición válida
+    static bool decodificar(const uint8_t* datos, size_t n, Repeticion& r);
+
+    bool guardar(const std::string& ruta) const;
+    static bool cargar(const std::string& ruta, Repeticion& r);
+};
+
+// Deja la partida como estaba al empezar la grabación
+template <class Cfg>
+bool prepararRepeticion(JuegoT<Cfg>& j, const Repeticion& r) {
+    if (j.cfg.tam() != r.lado) return false;
+    j.esBot = r.esBot;
+    j.ticksPorSegundo = r.ticksPorSegundo;
+    j.iniciarNivel(r.nivel, r.semilla);
+    return true;
+}
+
+// Aplica los eventos de r que tocan en el tick actual de j, empezando por
+// 'siguiente' (que avanza); llamar justo antes de cada actualizar()
+template <class Cfg>
+void aplicarEventos(JuegoT<Cfg>& j, const Repeticion& r, size_t& siguiente) {
+    while (siguiente < r.eventos.size() && r.eventos[siguiente].tick <= j.ticksDesdeInicio)
+        j.aplicar(r.eventos[siguiente++].orden);
+}
+
+struct ResultadoRepeticion {
+    bool valida = false; // la Cfg de j casaba con la grabación
+    int ticks = 0;
+    EstadoJuego estado = Jugando;
+    int frutasRecogidas = 0;
+
+    // Si la grabación trae resultado, si el motor ha llegado al mismo
+    bool coincide(const Repeticion& r) const {
+        return valida && (!r.hayResultado || (ticks == r.ticksFinal && estado == r.estadoFinal &&
+                                              frutasRecogidas == r.frutasFinal));
+    }
+};
+
+// Juega la repetición entera sin reloj, tan rápido como da la CPU
+template <class Cfg>
+ResultadoRepeticion reproducir(JuegoT<Cfg>& j, const Repeticion& r, int maxTicks) {
+    ResultadoRepeticion res;
+    if (!prepararRepeticion(j, r)) return res;
+    size_t siguiente = 0;
+    while (j.estado == Jugando && j.ticksDesdeInicio < maxTicks) {
+        aplicarEventos(j, r, siguiente);
+        j.actualizar();
+    }
+    res.valida = true;
+    res.ticks = j.ticksDesdeInicio;
+    res.estado = j.estado;
+    res.frutasRecogidas = j.jugador.frutas_recogidas;
+    return res;
+}
+
+#endif // NUCLEO_REPETICION_H
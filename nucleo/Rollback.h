@@ -0,0 +1,268 @@
+#ifndef NUCLEO_ROLLBACK_H
+#define NUCLEO_ROLLBACK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "Juego.h"
+
+// Órdenes de un jugador en un tick, en el orden en que se dieron
+struct EntradaTick {
+    static constexpr int MAX_ORDENES = 4;
+    uint8_t num = 0;
+    uint8_t codigos[MAX_ORDENES] = {};
+
+    // false si el tick ya va lleno: la orden se pierde
+    bool agregar(const Orden& o) {
+        if (num == MAX_ORDENES) return false;
+        codigos[num++] = static_cast<uint8_t>(codigoOrden(o));
+        return true;
+    }
+
+    bool operator==(const EntradaTick& o) const {
+        return num == o.num && std::equal(codigos, codigos + num, o.codigos);
+    }
+    bool operator!=(const EntradaTick& o) const { return !(*this == o); }
+
+    template <class Cfg>
+    void aplicarA(JuegoT<Cfg>& j) const {
+        for (int k = 0; k < num; k++) {
+            Orden o;
+            if (ordenDeCodigo(codigos[k], o)) j.aplicar(o);
+        }
+    }
+};
+
+// Resumen de lo que decide una partida, para comparar dos copias que deberían
+// ir iguales. Se mezclan los campos y no los bytes: el relleno no cuenta.
+template <class Cfg>
+uint64_t huellaPartida(const DatosPartidaT<Cfg>& d) {
+    uint64_t h = 14695981039346656037ull;
+    auto mezclar = [&h](uint64_t v) {
+        h ^= v;
+        h *= 1099511628211ull;
+    };
+    auto bits = [](float f) {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        return u;
+    };
+    mezclar(static_cast<uint64_t>(d.ticksDesdeInicio));
+    mezclar(static_cast<uint64_t>(d.estado));
+    mezclar(bits(d.jugador.pos.x));
+    mezclar(bits(d.jugador.pos.y));
+    mezclar(static_cast<uint64_t>(d.jugador.frutas_recogidas));
+    for (int i = 0; i < d.numEnemigos; i++) {
+        mezclar(bits(d.enemigos[i].pos.x));
+        mezclar(bits(d.enemigos[i].pos.y));
+        mezclar(static_cast<uint64_t>(d.enemigos[i].dir));
+    }
+    // El generador no deja ver su estado, pero una copia sí da su siguiente número
+    Aleatorio rng = d.rng;
+    mezclar(rng.siguiente());
+    return h;
+}
+
+// La de las dos partidas de un duelo, la que se intercambian los dos lados
+template <class Cfg>
+uint64_t huellaDuelo(const DatosPartidaT<Cfg>& d0, const DatosPartidaT<Cfg>& d1) {
+    return huellaPartida(d0) * 31 ^ huellaPartida(d1);
+}
+
+struct EstadisticasRollback {
+    long long vueltas = 0;           // veces que se volvió atrás
+    long long ticksResimulados = 0;
+    int maxVuelta = 0;               // ticks resimulados de una vez, como mucho
+    long long esperas = 0;           // veces que no se pudo avanzar por ir muy por delante
+};
+
+// Lockstep con predicción y vuelta atrás para dos jugadores, cada uno con su
+// JuegoT; los dos lados simulan las dos partidas. Las entradas propias se
+// conocen al momento ('retardo' ticks antes de aplicarse); las del otro llegan
+// tarde, así que mientras faltan se predice que no hizo nada y se sigue. Cada
+// tick guarda antes una foto (DatosPartidaT) de las dos partidas; si luego
+// llega una entrada distinta de la predicha, resolver() vuelve a la foto de ese
+// tick y resimula hasta el actual con lo que ya se sabe. Sin sockets ni reloj:
+// ver DueloRed.h.
+template <class Cfg>
+class SesionRollbackT {
+public:
+    static constexpr int JUGADORES = 2;
+    // Ticks con foto y entradas guardadas (potencia de 2). Cubre de sobra lo
+    // que un lado puede ir por delante del otro: 2 * MAX_PREDICCION + retardo.
+    static constexpr int VENTANA = 64;
+    // Ticks que se puede adelantar a la última entrada confirmada del otro
+    static constexpr int MAX_PREDICCION = 20;
+    static constexpr int MAX_RETARDO = 8;
+    // Cada cuántos ticks se toma la huella de las partidas ya confirmadas
+    static constexpr int INTERVALO_HUELLA = 60;
+
+    // j0 es la partida del jugador 0 (el anfitrión) en los dos lados
+    SesionRollbackT(JuegoT<Cfg>* j0, JuegoT<Cfg>* j1, int local)
+        : juegos{j0, j1}, yo(local), otro(1 - local), fotos(VENTANA) {
+        vaciar();
+    }
+
+    // Los dos juegos empiezan el mismo nivel con la misma semilla
+    void iniciar(int nivel, uint64_t semilla, int ticksPorSegundo, int retardoTicks) {
+        retardo = std::min(std::max(retardoTicks, 0), MAX_RETARDO);
+        for (auto* j : juegos) {
+            j->esBot = false;
+            j->ticksPorSegundo = ticksPorSegundo;
+            j->iniciarNivel(nivel, semilla);
+        }
+        vaciar();
+        // En los primeros 'retardo' ticks nadie ha podido ordenar nada todavía
+        for (int t = 0; t < retardo; t++)
+            for (int j = 0; j < JUGADORES; j++) fijar(j, t, EntradaTick());
+        propias = retardo;
+        confirmado = retardo;
+    }
+
+    int tick() const { return tickActual; }
+    int jugadorLocal() const { return yo; }
+    // Siguiente tick del otro sin entrada: todas las anteriores han llegado
+    int confirmadoRemoto() const { return confirmado; }
+    // Siguiente tick propio sin entrada fijada
+    int propiasFijadas() const { return propias; }
+    int retardoTicks() const { return retardo; }
+    bool puedeAvanzar() const { return tickActual - confirmado < MAX_PREDICCION; }
+    bool desincronizado() const { return desincronizada; }
+    const EstadisticasRollback& estadisticas() const { return est; }
+
+    // Entrada propia ya fijada, para mandarla; t en [propias - VENTANA, propias)
+    const EntradaTick& entradaLocal(int t) const { return entradas[yo][t & (VENTANA - 1)]; }
+
+    // Se aplica en el primer tick que se fije, 'retardo' ticks por delante del actual
+    bool ordenLocal(const Orden& o) { return pendiente.agregar(o); }
+
+    // Entrada del otro jugador para su tick t; las repetidas se ignoran
+    void entradaRemota(int t, const EntradaTick& e) {
+        if (t < confirmado || t >= confirmado + VENTANA || conocida(otro, t)) return;
+        fijar(otro, t, e);
+        if (t < tickActual && e != usada[t & (VENTANA - 1)])
+            vueltaDesde = vueltaDesde < 0 ? t : std::min(vueltaDesde, t);
+        while (conocida(otro, confirmado)) confirmado++;
+    }
+
+    // Vuelve atrás si alguna entrada del otro no era la predicha y resimula
+    // hasta el tick actual; llamar antes de avanzar() y antes de dibujar
+    bool resolver() {
+        bool volvio = vueltaDesde >= 0;
+        if (volvio) {
+            int desde = vueltaDesde;
+            vueltaDesde = -1;
+            const Foto& f = fotos[desde & (VENTANA - 1)];
+            for (int j = 0; j < JUGADORES; j++) juegos[j]->restaurar(f.datos[j]);
+            for (int t = desde; t < tickActual; t++) simular(t);
+            est.vueltas++;
+            est.ticksResimulados += tickActual - desde;
+            est.maxVuelta = std::max(est.maxVuelta, tickActual - desde);
+        }
+        tomarHuellas();
+        return volvio;
+    }
+
+    // Un tick: fija las órdenes propias pendientes, guarda la foto, aplica
+    // las entradas (las del otro, predichas si faltan) y actualiza las dos
+    // partidas. false si va demasiado por delante del otro.
+    bool avanzar() {
+        if (!puedeAvanzar()) {
+            est.esperas++;
+            return false;
+        }
+        fijar(yo, propias++, pendiente);
+        pendiente = EntradaTick();
+        simular(tickActual);
+        tickActual++;
+        return true;
+    }
+
+    // Última huella de las dos partidas con todas las entradas confirmadas
+    // (tick -1 si aún no hay ninguna), para que el otro la compare
+    int tickUltimaHuella() const { return ultimaHuella().tick; }
+    uint64_t valorUltimaHuella() const { return ultimaHuella().valor; }
+
+    // La del otro para el tick t; si aquí se tomó la misma y no coincide, las
+    // dos simulaciones ya no van iguales
+    void comprobarHuella(int t, uint64_t valor) {
+        for (const auto& h : huellas)
+            if (h.tick == t && h.valor != valor) desincronizada = true;
+    }
+
+private:
+    struct Foto {
+        DatosPartidaT<Cfg> datos[JUGADORES];
+    };
+    struct Huella {
+        int tick;
+        uint64_t valor;
+    };
+    static constexpr int HUELLAS = 8;
+
+    JuegoT<Cfg>* juegos[JUGADORES];
+    int yo, otro;
+    int retardo = 0;
+    int tickActual = 0;
+    int propias = 0;     // siguiente tick propio sin entrada
+    int confirmado = 0;  // siguiente tick del otro sin entrada
+    int vueltaDesde = -1;
+    EntradaTick pendiente;
+    EntradaTick entradas[JUGADORES][VENTANA];
+    int tickEntrada[JUGADORES][VENTANA]; // qué tick guarda cada hueco (-1 ninguno)
+    EntradaTick usada[VENTANA];          // lo que se aplicó del otro en cada tick
+    std::vector<Foto> fotos;             // estado antes de cada tick
+    Huella huellas[HUELLAS];
+    int siguienteHuella = 0;
+    bool desincronizada = false;
+    EstadisticasRollback est;
+
+    void vaciar() {
+        tickActual = propias = confirmado = 0;
+        pendiente = EntradaTick();
+        vueltaDesde = -1;
+        est = EstadisticasRollback();
+        for (auto& porJugador : tickEntrada) std::fill(std::begin(porJugador), std::end(porJugador), -1);
+        for (auto& h : huellas) h = {-1, 0};
+        siguienteHuella = 0;
+        desincronizada = false;
+    }
+
+    bool conocida(int j, int t) const { return tickEntrada[j][t & (VENTANA - 1)] == t; }
+    void fijar(int j, int t, const EntradaTick& e) {
+        entradas[j][t & (VENTANA - 1)] = e;
+        tickEntrada[j][t & (VENTANA - 1)] = t;
+    }
+
+    void simular(int t) {
+        const int s = t & (VENTANA - 1);
+        for (int j = 0; j < JUGADORES; j++) fotos[s].datos[j] = juegos[j]->guardar();
+        for (int j = 0; j < JUGADORES; j++) {
+            EntradaTick e = conocida(j, t) ? entradas[j][s] : EntradaTick();
+            if (j == otro) usada[s] = e;
+            e.aplicarA(*juegos[j]);
+        }
+        for (auto* juego : juegos) juego->actualizar();
+    }
+
+    // La foto del tick c es definitiva cuando han llegado todas las entradas
+    // anteriores a c y no queda ninguna vuelta atrás pendiente
+    void tomarHuellas() {
+        int c = ultimaHuella().tick < 0 ? 0 : ultimaHuella().tick + INTERVALO_HUELLA;
+        for (; c < std::min(confirmado, tickActual); c += INTERVALO_HUELLA) {
+            if (c < tickActual - VENTANA) continue;
+            const Foto& f = fotos[c & (VENTANA - 1)];
+            Huella& h = huellas[siguienteHuella++ % HUELLAS];
+            h.tick = c;
+            h.valor = huellaDuelo(f.datos[0], f.datos[1]);
+        }
+    }
+    const Huella& ultimaHuella() const { return huellas[(siguienteHuella + HUELLAS - 1) % HUELLAS]; }
+};
+
+using SesionRollback = SesionRollbackT<ConfigClasica>;
+
+#endif // NUCLEO_ROLLBACK_H
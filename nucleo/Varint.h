@@ -0,0 +1,37 @@
+#ifndef NUCLEO_VARINT_H
+#define NUCLEO_VARINT_H
+
+#include <cstdint>
+#include <vector>
+
+// Enteros sin signo en LEB128: 7 bits por byte, el bit alto indica que sigue
+// otro. Los valores pequeños (deltas de tick, contadores) ocupan un byte.
+inline void escribirVarint(std::vector<uint8_t>& b, uint64_t v) {
+    while (v >= 0x80) {
+        b.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    b.push_back(static_cast<uint8_t>(v));
+}
+
+// Lee de [p, fin) sin pasarse; false si se acaba o no cabe en 64 bits
+inline bool leerVarint(const uint8_t*& p, const uint8_t* fin, uint64_t& v) {
+    v = 0;
+    for (int desplaza = 0; desplaza < 64; desplaza += 7) {
+        if (p == fin) return false;
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << desplaza;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Varint con tope, para los campos que acaban en un int
+inline bool leerEntero(const uint8_t*& p, const uint8_t* fin, int& v, uint64_t max = 0x7FFFFFFF) {
+    uint64_t x;
+    if (!leerVarint(p, fin, x) || x > max) return false;
+    v = static_cast<int>(x);
+    return true;
+}
+
+#endif // NUCLEO_VARINT_H